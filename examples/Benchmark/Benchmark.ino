@@ -0,0 +1,372 @@
+/**-----------------------------------------------------------------------------
+
+    Benchmark of the Chirp SDK audio processing, running the encoder output
+    straight back into the decoder.
+
+    @file Benchmark.ino
+
+    @brief Create a developer account at https://developers.chirp.io,
+    and copy and paste your key, secret and config string for the
+    "16khz-mono-embedded" protocol into the credentials.h file. Other
+    configs can be benchmarked by adding them to the `configs` array below.
+
+    For each config, payload length and block size, a random payload is sent
+    and the output of `chirp_sdk_process` / `chirp_sdk_process_shorts` is
+    passed back as the input of the next block, with listen to self enabled.
+    No audio hardware is needed.
+
+    The time taken to start the SDK is printed first, with one line per
+    config, in CSV format :
+
+      config,new_us,set_config_us,start_us
+
+    where `new_us` is the time spent in `new_chirp_sdk`, `set_config_us` in
+    `chirp_sdk_set_config`, which decodes and verifies the config string,
+    and `start_us` in `chirp_sdk_start`. This is the cost of booting the SDK
+    again after deep sleep.
+
+    Then one line is printed per run, in CSV format :
+
+      config,channels,heap,max_heap,function,payload,block,samples,decoded,latency_ms,us_per_block,cycles_per_block,max_us_per_block,max_block_load,samples_per_s,rtf
+
+    where `channels` is the channel count of the config, `heap` the heap
+    used by the SDK in bytes once started, as given by
+    `chirp_sdk_get_heap_requirement`, `max_heap` the largest heap usage of
+    the SDK seen between blocks and in `on_received` during the run, which
+    includes the payload sent and the allocations made to decode it,
+    `latency_ms` the time from the end of the chirp to `on_received` (-1 if
+    nothing was received), `cycles_per_block`
+    is derived from the CPU clock (0 if F_CPU is not defined by the board)
+    and `rtf` is the real-time factor, ie. the CPU time spent processing
+    divided by the duration of the audio processed. An rtf of 0.25 means a
+    quarter of the CPU is used to send and receive in real time.
+
+    `max_us_per_block` is the longest time spent processing a single block,
+    typically the one in which the payload is error corrected just before
+    `on_received`, and `max_block_load` is that time divided by the duration
+    of a block. It must stay under 1 for the decoding spike to fit in the
+    audio deadline, with some margin for the rest of the application.
+
+    The `process_shorts_48k` and `resampler_48k` runs compare the cost of
+    audio hardware running at 48kHz, either processed directly by the SDK
+    at 48kHz or resampled to and from 16kHz by `chirp_sdk_resampler_t`.
+    Their block sizes and sample counts are at 48kHz.
+
+    The latency is measured in audio time, to within one block, and does not
+    include the time the audio driver holds the samples for. Smaller blocks
+    lower the latency at the cost of a higher CPU usage per sample.
+
+    The SDK listens on every channel of a config at once. Adding configs
+    with 1, 2, 4 and 8 channels to the `configs` array gives the CPU and
+    heap cost of each channel count.
+
+    *Note*: This example needs a board which can receive data. It will not
+    run on the send-only cortex-m0plus boards (MKRZero, MKR Vidor 4000).
+
+    Copyright © 2011-2019, Asio Ltd.
+    All rights reserved.
+
+  ----------------------------------------------------------------------------*/
+#include "chirp_sdk.h"
+#include "chirp_sdk_memory.h"
+#include "chirp_sdk_resampler.h"
+#include "credentials.h"
+
+#define SAMPLE_RATE           16000
+#define HARDWARE_SAMPLE_RATE  48000
+#define RESAMPLE_FACTOR       (HARDWARE_SAMPLE_RATE / SAMPLE_RATE)
+#define MAX_BUFFER_SIZE       512
+
+typedef enum {
+  MODE_PROCESS,
+  MODE_PROCESS_SHORTS,
+  MODE_PROCESS_SHORTS_HARDWARE,
+  MODE_RESAMPLER,
+  MODE_COUNT
+} benchmarkMode_t;
+
+// Global variables ------------------------------------------------------------
+
+static const char *configs[] = { CHIRP_APP_CONFIG };
+static const size_t blockSizes[] = { 64, 128, 256, 512 };
+static const char *modeNames[MODE_COUNT] = { "process", "process_shorts", "process_shorts_48k", "resampler_48k" };
+
+static float floatBuffers[2][MAX_BUFFER_SIZE];
+static short shortBuffers[2][MAX_BUFFER_SIZE];
+static chirp_sdk_resampler_t inputResampler;
+static chirp_sdk_resampler_t outputResampler;
+
+static uint8_t *sentPayload = NULL;
+static size_t sentLength = 0;
+static volatile bool received = false;
+static volatile bool decoded = false;
+static int32_t maxHeapUsage = 0;
+
+// Function definitions --------------------------------------------------------
+
+void runBootBenchmark(size_t configIndex);
+void runBenchmark(size_t configIndex, benchmarkMode_t mode, size_t payloadLength, size_t blockSize, int32_t heapUsage);
+void updateMaxHeapUsage(chirp_sdk_t *chirp);
+void onReceivedCallback(void *ptr, uint8_t *payload, size_t length, uint8_t channel);
+void chirpErrorHandler(chirp_sdk_error_code_t code);
+
+// Main ------------------------------------------------------------------------
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print("Chirp SDK benchmark - v");
+  Serial.print(chirp_sdk_get_version());
+  Serial.print(" [");
+  Serial.print(chirp_sdk_get_build_number());
+  Serial.println("]");
+
+  Serial.println("config,new_us,set_config_us,start_us");
+  for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+  {
+    runBootBenchmark(c);
+  }
+  Serial.println();
+
+  Serial.println("config,channels,heap,max_heap,function,payload,block,samples,decoded,latency_ms,us_per_block,cycles_per_block,max_us_per_block,max_block_load,samples_per_s,rtf");
+
+  for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+  {
+    chirp_sdk_t *chirp = new_chirp_sdk(CHIRP_APP_KEY, CHIRP_APP_SECRET);
+    if (chirp == NULL)
+    {
+      Serial.println("Chirp initialisation failed.");
+      return;
+    }
+    chirpErrorHandler(chirp_sdk_set_config(chirp, configs[c]));
+    size_t maxLength = chirp_sdk_get_max_payload_length(chirp);
+    chirpErrorHandler(del_chirp_sdk(&chirp));
+
+    // The heap requirement creates an SDK of its own, so it is queried once
+    // per config and sample rate, away from the measured runs.
+    int32_t heapUsage = 0;
+    int32_t hardwareHeapUsage = 0;
+    chirpErrorHandler(chirp_sdk_get_heap_requirement(CHIRP_APP_KEY, CHIRP_APP_SECRET, configs[c],
+                                                     SAMPLE_RATE, SAMPLE_RATE, &heapUsage));
+    chirpErrorHandler(chirp_sdk_get_heap_requirement(CHIRP_APP_KEY, CHIRP_APP_SECRET, configs[c],
+                                                     HARDWARE_SAMPLE_RATE, HARDWARE_SAMPLE_RATE, &hardwareHeapUsage));
+
+    size_t payloadLengths[] = { 1, maxLength / 2, maxLength };
+    for (size_t p = 0; p < sizeof(payloadLengths) / sizeof(payloadLengths[0]); p++)
+    {
+      if (payloadLengths[p] == 0)
+        continue;
+      for (size_t b = 0; b < sizeof(blockSizes) / sizeof(blockSizes[0]); b++)
+      {
+        for (int m = 0; m < MODE_COUNT; m++)
+        {
+          runBenchmark(c, (benchmarkMode_t) m, payloadLengths[p], blockSizes[b],
+                       m == MODE_PROCESS_SHORTS_HARDWARE ? hardwareHeapUsage : heapUsage);
+        }
+      }
+    }
+  }
+
+  Serial.println("Benchmark complete.");
+}
+
+void loop()
+{
+}
+
+// Benchmark -------------------------------------------------------------------
+
+void runBootBenchmark(size_t configIndex)
+{
+  uint32_t start = micros();
+  chirp_sdk_t *chirp = new_chirp_sdk(CHIRP_APP_KEY, CHIRP_APP_SECRET);
+  uint32_t newTime = micros() - start;
+  if (chirp == NULL)
+  {
+    Serial.println("Chirp initialisation failed.");
+    return;
+  }
+
+  start = micros();
+  chirpErrorHandler(chirp_sdk_set_config(chirp, configs[configIndex]));
+  uint32_t setConfigTime = micros() - start;
+
+  start = micros();
+  chirpErrorHandler(chirp_sdk_start(chirp));
+  uint32_t startTime = micros() - start;
+
+  Serial.print(configIndex);
+  Serial.print(",");
+  Serial.print(newTime);
+  Serial.print(",");
+  Serial.print(setConfigTime);
+  Serial.print(",");
+  Serial.println(startTime);
+
+  chirpErrorHandler(chirp_sdk_stop(chirp));
+  chirpErrorHandler(del_chirp_sdk(&chirp));
+}
+
+void runBenchmark(size_t configIndex, benchmarkMode_t mode, size_t payloadLength, size_t blockSize, int32_t heapUsage)
+{
+  uint32_t hardwareRate = mode >= MODE_PROCESS_SHORTS_HARDWARE ? HARDWARE_SAMPLE_RATE : SAMPLE_RATE;
+  uint32_t sdkRate = mode == MODE_PROCESS_SHORTS_HARDWARE ? HARDWARE_SAMPLE_RATE : SAMPLE_RATE;
+
+  chirp_sdk_t *chirp = new_chirp_sdk(CHIRP_APP_KEY, CHIRP_APP_SECRET);
+  if (chirp == NULL)
+  {
+    Serial.println("Chirp initialisation failed.");
+    return;
+  }
+
+  chirpErrorHandler(chirp_sdk_set_config(chirp, configs[configIndex]));
+
+  chirp_sdk_callback_set_t callbacks = {0};
+  callbacks.on_received = onReceivedCallback;
+  chirpErrorHandler(chirp_sdk_set_callbacks(chirp, callbacks));
+  chirpErrorHandler(chirp_sdk_set_callback_ptr(chirp, chirp));
+
+  chirpErrorHandler(chirp_sdk_set_input_sample_rate(chirp, sdkRate));
+  chirpErrorHandler(chirp_sdk_set_output_sample_rate(chirp, sdkRate));
+  chirpErrorHandler(chirp_sdk_set_listen_to_self(chirp, true));
+  chirpErrorHandler(chirp_sdk_start(chirp));
+
+  if (mode == MODE_RESAMPLER)
+  {
+    chirpErrorHandler(chirp_sdk_resampler_init(&inputResampler, chirp, CHIRP_SDK_RESAMPLER_INPUT, RESAMPLE_FACTOR));
+    chirpErrorHandler(chirp_sdk_resampler_init(&outputResampler, chirp, CHIRP_SDK_RESAMPLER_OUTPUT, RESAMPLE_FACTOR));
+  }
+
+  memset(floatBuffers, 0, sizeof(floatBuffers));
+  memset(shortBuffers, 0, sizeof(shortBuffers));
+  received = false;
+  decoded = false;
+  maxHeapUsage = chirp_sdk_get_heap_usage(chirp);
+
+  sentLength = payloadLength;
+  sentPayload = chirp_sdk_random_payload(chirp, &sentLength);
+  chirpErrorHandler(chirp_sdk_send(chirp, sentPayload, sentLength));
+
+  // Allow an extra second of audio after the end of the chirp for the
+  // decoder to report the payload.
+  float duration = chirp_sdk_get_duration_for_payload_length(chirp, sentLength);
+  size_t maxSamples = (size_t) ((duration + 1.0f) * hardwareRate);
+
+  size_t samples = 0;
+  size_t blocks = 0;
+  uint32_t elapsed = 0;
+  uint32_t maxElapsed = 0;
+  uint8_t current = 0;
+
+  while (!received && samples < maxSamples)
+  {
+    uint8_t next = current ^ 1;
+    uint32_t start = micros();
+    if (mode == MODE_PROCESS)
+    {
+      chirpErrorHandler(chirp_sdk_process(chirp, floatBuffers[current], floatBuffers[next], blockSize));
+    }
+    else if (mode == MODE_RESAMPLER)
+    {
+      chirpErrorHandler(chirp_sdk_resampler_process_shorts_input(&inputResampler, shortBuffers[current], blockSize));
+      chirpErrorHandler(chirp_sdk_resampler_process_shorts_output(&outputResampler, shortBuffers[next], blockSize));
+    }
+    else
+    {
+      chirpErrorHandler(chirp_sdk_process_shorts(chirp, shortBuffers[current], shortBuffers[next], blockSize));
+    }
+    uint32_t blockElapsed = micros() - start;
+    elapsed += blockElapsed;
+    if (blockElapsed > maxElapsed)
+    {
+      maxElapsed = blockElapsed;
+    }
+    updateMaxHeapUsage(chirp);
+    current = next;
+    samples += blockSize;
+    blocks++;
+  }
+
+  float seconds = elapsed / 1e6f;
+  Serial.print(configIndex);
+  Serial.print(",");
+  Serial.print(chirp_sdk_get_channel_count(chirp));
+  Serial.print(",");
+  Serial.print(heapUsage);
+  Serial.print(",");
+  Serial.print(maxHeapUsage);
+  Serial.print(",");
+  Serial.print(modeNames[mode]);
+  Serial.print(",");
+  Serial.print(sentLength);
+  Serial.print(",");
+  Serial.print(blockSize);
+  Serial.print(",");
+  Serial.print(samples);
+  Serial.print(",");
+  Serial.print(decoded ? 1 : 0);
+  Serial.print(",");
+  // The chirp starts at the first output sample, and each output block is
+  // decoded as the next input block.
+  if (received)
+  {
+    float endOfChirp = duration * hardwareRate + blockSize;
+    Serial.print((samples - endOfChirp) * 1000.0f / hardwareRate, 1);
+  }
+  else
+  {
+    Serial.print(-1);
+  }
+  Serial.print(",");
+  Serial.print((float) elapsed / blocks, 1);
+  Serial.print(",");
+#ifdef F_CPU
+  Serial.print((float) elapsed / blocks * (F_CPU / 1000000), 0);
+#else
+  Serial.print(0);
+#endif
+  Serial.print(",");
+  Serial.print(maxElapsed);
+  Serial.print(",");
+  Serial.print(maxElapsed * (hardwareRate / 1e6f) / blockSize, 4);
+  Serial.print(",");
+  Serial.print(seconds > 0 ? samples / seconds : 0.0f, 0);
+  Serial.print(",");
+  Serial.println(seconds * hardwareRate / samples, 4);
+
+  chirp_sdk_free(sentPayload);
+  sentPayload = NULL;
+  chirpErrorHandler(chirp_sdk_stop(chirp));
+  chirpErrorHandler(del_chirp_sdk(&chirp));
+}
+
+// Chirp -----------------------------------------------------------------------
+
+void updateMaxHeapUsage(chirp_sdk_t *chirp)
+{
+  int32_t heapUsage = chirp_sdk_get_heap_usage(chirp);
+  if (heapUsage > maxHeapUsage)
+  {
+    maxHeapUsage = heapUsage;
+  }
+}
+
+void onReceivedCallback(void *ptr, uint8_t *payload, size_t length, uint8_t channel)
+{
+  // The decoded payload is still held by the SDK while it is reported.
+  updateMaxHeapUsage((chirp_sdk_t *) ptr);
+  received = true;
+  decoded = payload && length == sentLength && memcmp(payload, sentPayload, length) == 0;
+}
+
+void chirpErrorHandler(chirp_sdk_error_code_t code)
+{
+  if (code != CHIRP_SDK_OK)
+  {
+    const char *errorString = chirp_sdk_error_code_to_string(code);
+    Serial.println(errorString);
+    exit(42);
+  }
+}
@@ -0,0 +1,278 @@
+/**-----------------------------------------------------------------------------
+
+    Simulation of the Chirp SDK decoding performance through an acoustic
+    channel, running the encoder output back into the decoder.
+
+    @file ChannelSimulator.ino
+
+    @brief Create a developer account at https://developers.chirp.io,
+    and copy and paste your key, secret and config string for the
+    "16khz-mono-embedded" protocol into the credentials.h file. Other
+    configs can be simulated by adding them to the `configs` array below.
+
+    For each config, scenario and signal to noise ratio, a number of
+    payloads are sent through a `chirp_sdk_channel_t`, which adds white
+    noise, room reverb, clock drift and dropped blocks to the audio before
+    it is decoded. The payloads and the channel are drawn from fixed seeds,
+    so that two runs of the same SDK version give the same results, and
+    different versions can be compared. No audio hardware is needed.
+
+    One line is printed per scenario and SNR, in CSV format :
+
+      config,scenario,snr_db,trials,decoded,success_rate,us_per_decode
+
+    where `success_rate` is the proportion of payloads decoded correctly,
+    and `us_per_decode` the average CPU time spent in the decoder for each
+    payload. The time spent simulating the channel is not included.
+
+    The SNR is relative to the RMS level of the chirps at the volume used,
+    measured once per config.
+
+    *Note*: This example needs a board which can receive data. It will not
+    run on the send-only cortex-m0plus boards (MKRZero, MKR Vidor 4000).
+
+    Copyright © 2011-2019, Asio Ltd.
+    All rights reserved.
+
+  ----------------------------------------------------------------------------*/
+#include "chirp_sdk.h"
+#include "chirp_sdk_channel.h"
+#include "credentials.h"
+
+#define SAMPLE_RATE       16000
+#define BLOCK_SIZE        256
+#define REVERB_LENGTH     2048
+#define TRIALS            10
+
+typedef struct {
+  const char *name;
+  float rt60;
+  float drift;
+  float dropProbability;
+} scenario_t;
+
+// Global variables ------------------------------------------------------------
+
+static const char *configs[] = { CHIRP_APP_CONFIG };
+static const float snrs[] = { -6, -3, 0, 3, 6, 12, 24 };
+static const scenario_t scenarios[] = {
+  { "noise",   0.0f, 1.0f,   0.0f   },
+  { "reverb",  0.3f, 1.0f,   0.0f   },
+  { "drift",   0.0f, 1.005f, 0.0f   },
+  { "drops",   0.0f, 1.0f,   0.01f  },
+  { "room",    0.3f, 1.002f, 0.005f },
+};
+
+static short sendBuffer[BLOCK_SIZE];
+static short receiveBuffer[2 * BLOCK_SIZE];
+static float impulseResponse[REVERB_LENGTH];
+static float reverbHistory[REVERB_LENGTH];
+static chirp_sdk_channel_t channel;
+
+static uint8_t sentPayload[32];
+static size_t sentLength = 0;
+static volatile bool received = false;
+static volatile bool decoded = false;
+
+// Function definitions --------------------------------------------------------
+
+float measureSignalLevel(size_t configIndex);
+bool runTrial(size_t configIndex, const scenario_t *scenario, float signalRms, float snr, uint32_t seed, uint32_t *elapsed);
+chirp_sdk_t *createChirp(size_t configIndex);
+void onReceivedCallback(void *ptr, uint8_t *payload, size_t length, uint8_t channel);
+void chirpErrorHandler(chirp_sdk_error_code_t code);
+
+// Main ------------------------------------------------------------------------
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print("Chirp SDK channel simulator - v");
+  Serial.print(chirp_sdk_get_version());
+  Serial.print(" [");
+  Serial.print(chirp_sdk_get_build_number());
+  Serial.println("]");
+  Serial.println("config,scenario,snr_db,trials,decoded,success_rate,us_per_decode");
+
+  for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+  {
+    float signalRms = measureSignalLevel(c);
+
+    for (size_t s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++)
+    {
+      for (size_t n = 0; n < sizeof(snrs) / sizeof(snrs[0]); n++)
+      {
+        uint32_t decodedCount = 0;
+        uint32_t totalElapsed = 0;
+
+        for (uint32_t t = 0; t < TRIALS; t++)
+        {
+          uint32_t elapsed = 0;
+          if (runTrial(c, &scenarios[s], signalRms, snrs[n], t + 1, &elapsed))
+          {
+            decodedCount++;
+          }
+          totalElapsed += elapsed;
+        }
+
+        Serial.print(c);
+        Serial.print(",");
+        Serial.print(scenarios[s].name);
+        Serial.print(",");
+        Serial.print(snrs[n], 0);
+        Serial.print(",");
+        Serial.print(TRIALS);
+        Serial.print(",");
+        Serial.print(decodedCount);
+        Serial.print(",");
+        Serial.print((float) decodedCount / TRIALS, 2);
+        Serial.print(",");
+        Serial.println(totalElapsed / TRIALS);
+      }
+    }
+  }
+
+  Serial.println("Simulation complete.");
+}
+
+void loop()
+{
+}
+
+// Simulation ------------------------------------------------------------------
+
+float measureSignalLevel(size_t configIndex)
+{
+  chirp_sdk_t *chirp = createChirp(configIndex);
+  if (chirp == NULL)
+    return 0;
+
+  sentLength = chirp_sdk_get_max_payload_length(chirp);
+  if (sentLength > sizeof(sentPayload))
+  {
+    sentLength = sizeof(sentPayload);
+  }
+  memset(sentPayload, 0x55, sizeof(sentPayload));
+  chirpErrorHandler(chirp_sdk_send(chirp, sentPayload, sentLength));
+
+  float duration = chirp_sdk_get_duration_for_payload_length(chirp, sentLength);
+  size_t length = (size_t) (duration * SAMPLE_RATE);
+  double energy = 0;
+
+  for (size_t samples = 0; samples < length; samples += BLOCK_SIZE)
+  {
+    chirpErrorHandler(chirp_sdk_process_shorts_output(chirp, sendBuffer, BLOCK_SIZE));
+    for (size_t i = 0; i < BLOCK_SIZE; i++)
+    {
+      energy += (float) sendBuffer[i] * sendBuffer[i];
+    }
+  }
+
+  chirpErrorHandler(chirp_sdk_stop(chirp));
+  chirpErrorHandler(del_chirp_sdk(&chirp));
+
+  return length ? sqrt(energy / length) : 0;
+}
+
+bool runTrial(size_t configIndex, const scenario_t *scenario, float signalRms, float snr, uint32_t seed, uint32_t *elapsed)
+{
+  chirp_sdk_t *chirp = createChirp(configIndex);
+  if (chirp == NULL)
+    return false;
+
+  chirpErrorHandler(chirp_sdk_channel_init(&channel, seed));
+  chirpErrorHandler(chirp_sdk_channel_set_noise(&channel, signalRms, snr));
+  chirpErrorHandler(chirp_sdk_channel_set_drift(&channel, scenario->drift));
+  chirpErrorHandler(chirp_sdk_channel_set_drop_probability(&channel, scenario->dropProbability));
+  if (scenario->rt60 > 0)
+  {
+    chirpErrorHandler(chirp_sdk_channel_generate_reverb(&channel, impulseResponse, REVERB_LENGTH, SAMPLE_RATE, scenario->rt60));
+    chirpErrorHandler(chirp_sdk_channel_set_reverb(&channel, impulseResponse, reverbHistory, REVERB_LENGTH));
+  }
+
+  // The payload is drawn from the seed rather than chirp_sdk_random_payload
+  // so that each trial is repeatable. The core also has a seed of its own,
+  // but its setter is not declared in chirp_sdk.h, and this example only
+  // uses the public API so that it runs unchanged against any SDK version.
+  sentLength = chirp_sdk_get_max_payload_length(chirp);
+  if (sentLength > sizeof(sentPayload))
+  {
+    sentLength = sizeof(sentPayload);
+  }
+  uint32_t state = seed * 2654435761u;
+  for (size_t i = 0; i < sentLength; i++)
+  {
+    state = state * 1664525u + 1013904223u;
+    sentPayload[i] = state >> 24;
+  }
+
+  received = false;
+  decoded = false;
+  chirpErrorHandler(chirp_sdk_send(chirp, sentPayload, sentLength));
+
+  // Allow an extra second of audio after the end of the chirp for the
+  // decoder to report the payload.
+  float duration = chirp_sdk_get_duration_for_payload_length(chirp, sentLength);
+  size_t maxSamples = (size_t) ((duration + 1.0f) * SAMPLE_RATE);
+
+  *elapsed = 0;
+  for (size_t samples = 0; !received && samples < maxSamples; samples += BLOCK_SIZE)
+  {
+    size_t length = 0;
+    chirpErrorHandler(chirp_sdk_process_shorts_output(chirp, sendBuffer, BLOCK_SIZE));
+    chirpErrorHandler(chirp_sdk_channel_process_shorts(&channel, sendBuffer, BLOCK_SIZE,
+                                                       receiveBuffer, sizeof(receiveBuffer) / sizeof(receiveBuffer[0]), &length));
+
+    uint32_t start = micros();
+    chirpErrorHandler(chirp_sdk_process_shorts_input(chirp, receiveBuffer, length));
+    *elapsed += micros() - start;
+  }
+
+  chirpErrorHandler(chirp_sdk_stop(chirp));
+  chirpErrorHandler(del_chirp_sdk(&chirp));
+
+  return decoded;
+}
+
+// Chirp -----------------------------------------------------------------------
+
+chirp_sdk_t *createChirp(size_t configIndex)
+{
+  chirp_sdk_t *chirp = new_chirp_sdk(CHIRP_APP_KEY, CHIRP_APP_SECRET);
+  if (chirp == NULL)
+  {
+    Serial.println("Chirp initialisation failed.");
+    return NULL;
+  }
+
+  chirpErrorHandler(chirp_sdk_set_config(chirp, configs[configIndex]));
+
+  chirp_sdk_callback_set_t callbacks = {0};
+  callbacks.on_received = onReceivedCallback;
+  chirpErrorHandler(chirp_sdk_set_callbacks(chirp, callbacks));
+
+  chirpErrorHandler(chirp_sdk_set_input_sample_rate(chirp, SAMPLE_RATE));
+  chirpErrorHandler(chirp_sdk_set_output_sample_rate(chirp, SAMPLE_RATE));
+  chirpErrorHandler(chirp_sdk_set_listen_to_self(chirp, true));
+  chirpErrorHandler(chirp_sdk_start(chirp));
+
+  return chirp;
+}
+
+void onReceivedCallback(void *ptr, uint8_t *payload, size_t length, uint8_t channel)
+{
+  received = true;
+  decoded = payload && length == sentLength && memcmp(payload, sentPayload, length) == 0;
+}
+
+void chirpErrorHandler(chirp_sdk_error_code_t code)
+{
+  if (code != CHIRP_SDK_OK)
+  {
+    const char *errorString = chirp_sdk_error_code_to_string(code);
+    Serial.println(errorString);
+    exit(42);
+  }
+}
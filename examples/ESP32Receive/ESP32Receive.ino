@@ -22,6 +22,8 @@
 #include <driver/i2s.h>
 
 #include "chirp_sdk.h"
+#include "chirp_sdk_audio.h"
+#include "chirp_sdk_monitor.h"
 #include "credentials.h"
 
 #define I2SI_DATA         12     // I2S DATA IN on GPIO32
@@ -35,18 +37,15 @@
 #define SAMPLE_RATE       16000  // Audio sample rate
 
 /**
-   Convert I2S input data.
-   Data is 18 bit signed, MSBit first, two's complement.
-   The MIC_CALIBRATION value is determined using the Serial
-   Plotter to centre the audio about zero. The below value
-   should be correct for most ESP32 boards.
+   I2S input data is 18 bit signed, MSBit first, two's complement.
+   The microphone DC offset is removed by the SDK.
 */
-#define MIC_CALIBRATION   13125
-#define CONVERT_INPUT(sample) (((int32_t)(sample) >> 14) + MIC_CALIBRATION)
+#define MIC_BIT_DEPTH     18
 
 // Global variables ------------------------------------------------------------
 
 static chirp_sdk_t *chirp = NULL;
+static chirp_sdk_monitor_t monitor;
 static chirp_sdk_state_t currentState = CHIRP_SDK_STATE_NOT_CREATED;
 static bool startTasks = false;
 
@@ -102,21 +101,26 @@ void processInputTask(void *parameter)
   chirp_sdk_error_code_t chirpError;
 
   size_t bytesLength = 0;
-  float buffer[BUFFER_SIZE] = {0};
   int32_t ibuffer[BUFFER_SIZE] = {0};
 
+  chirp_sdk_i32_input_t input;
+  chirpError = chirp_sdk_i32_input_init(&input, MIC_BIT_DEPTH, 0);
+  chirpErrorHandler(chirpError);
+
+  // Report any audio lost because this task fell behind the I2S driver.
+  chirpError = chirp_sdk_monitor_init(&monitor, chirp, micros, 2 * BUFFER_SIZE);
+  chirpErrorHandler(chirpError);
+  chirpError = chirp_sdk_monitor_set_callback(&monitor, onMonitorEventCallback, NULL);
+  chirpErrorHandler(chirpError);
+
   while (currentState >= CHIRP_SDK_STATE_RUNNING)
   {
     audioError = i2s_read(I2S_NUM_0, ibuffer, BUFFER_SIZE * 4, &bytesLength, portMAX_DELAY);
     if (bytesLength)
     {
-      for (int i = 0; i < bytesLength / 4; i++)
-      {
-        buffer[i] = (float) CONVERT_INPUT(ibuffer[i]);
-      }
-
-      chirpError = chirp_sdk_process_input(chirp, buffer, bytesLength / 4);
+      chirpError = chirp_sdk_process_i32_input(chirp, &input, ibuffer, bytesLength / 4);
       chirpErrorHandler(chirpError);
+      chirp_sdk_monitor_input(&monitor, bytesLength / 4);
     }
   }
   vTaskDelete(NULL);
@@ -152,6 +156,25 @@ void onReceivedCallback(void *chirp, uint8_t *payload, size_t length, uint8_t ch
   }
 }
 
+void onMonitorEventCallback(void *ptr, chirp_sdk_monitor_event_t event, uint32_t samples)
+{
+  switch (event)
+  {
+    case CHIRP_SDK_MONITOR_INPUT_OVERRUN:
+      Serial.printf("Input overrun, %u samples lost\n", samples);
+      break;
+    case CHIRP_SDK_MONITOR_OUTPUT_UNDERRUN:
+      Serial.printf("Output underrun, %u samples missing\n", samples);
+      break;
+    case CHIRP_SDK_MONITOR_INPUT_DISCONTINUITY:
+      Serial.printf("Input discontinuity, %u samples too many\n", samples);
+      break;
+    case CHIRP_SDK_MONITOR_OUTPUT_DISCONTINUITY:
+      Serial.printf("Output discontinuity, %u samples too many\n", samples);
+      break;
+  }
+}
+
 void setupChirp()
 {
   chirp = new_chirp_sdk(CHIRP_APP_KEY, CHIRP_APP_SECRET);
@@ -9,8 +9,9 @@
     and copy and paste your key, secret and config string for the
     "16khz-mono-embedded" protocol into the credentials.h file.
 
-    When the EN switch is pressed on the board, a random chirp will be sent to
-    the audio output.
+    When the EN switch is pressed on the board, a chirp will be sent to
+    the audio output. Presses made while a chirp is being sent are queued
+    and sent straight after it.
 
     Note: this example can be used in conjunction with the receive example,
     to send and receive data in the same application.
@@ -22,6 +23,8 @@
 #include <driver/i2s.h>
 
 #include "chirp_sdk.h"
+#include "chirp_sdk_audio.h"
+#include "chirp_sdk_send_queue.h"
 #include "credentials.h"
 
 #define I2SO_DATA         23     // I2S DATA OUT on GPIO23
@@ -35,9 +38,17 @@
 #define BUFFER_SIZE       512
 #define SAMPLE_RATE       16000
 
+/**
+   I2S output data is 32 bit words, MSBit first, two's complement, of which
+   the UDA1334 uses the top 24 bits.
+*/
+#define DAC_BIT_DEPTH     24
+
 // Global variables ------------------------------------------------------------
 
 static chirp_sdk_t *chirp = NULL;
+static chirp_sdk_send_queue_t sendQueue;
+static chirp_sdk_dac_output_t dacOutput;
 static chirp_sdk_state_t currentState = CHIRP_SDK_STATE_NOT_CREATED;
 static volatile bool buttonPressed = false;
 static bool startTasks = false;
@@ -78,10 +89,17 @@ void loop()
   if (buttonPressed)
   {
     char *payload = "hello";
-    chirpError = chirp_sdk_send(chirp, (uint8_t *)payload, strlen(payload));
-    chirpErrorHandler(chirpError);
-    Serial.print("Sending data: ");
-    Serial.println(payload);
+    chirpError = chirp_sdk_send_queue_push(&sendQueue, (uint8_t *)payload, strlen(payload));
+    if (chirpError == CHIRP_SDK_ALREADY_SENDING)
+    {
+      Serial.println("Send queue is full.");
+    }
+    else
+    {
+      chirpErrorHandler(chirpError);
+      Serial.print("Queued data: ");
+      Serial.println(payload);
+    }
     buttonPressed = false;
   }
 }
@@ -111,18 +129,18 @@ void processOutputTask(void *parameter)
   chirp_sdk_error_code_t chirpError;
 
   size_t bytesLength = 0;
-  short buffer[BUFFER_SIZE] = {0};
   int32_t ibuffer[BUFFER_SIZE] = {0};
 
+  // The audio is synthesised straight into the I2S words. At 24 bits the
+  // quantisation is far below the noise of the DAC, so no dither is needed.
+  chirpError = chirp_sdk_dac_output_init(&dacOutput, DAC_BIT_DEPTH, 1, false);
+  chirpErrorHandler(chirpError);
+
   while (currentState >= CHIRP_SDK_STATE_RUNNING)
   {
-    chirpError = chirp_sdk_process_shorts_output(chirp, buffer, BUFFER_SIZE);
+    chirpError = chirp_sdk_send_queue_process_i32_output(&sendQueue, &dacOutput, ibuffer, BUFFER_SIZE);
     chirpErrorHandler(chirpError);
 
-    for (int i = 0; i < BUFFER_SIZE; i++)
-    {
-      ibuffer[i] = (int32_t) buffer[i];
-    }
     audioError = i2s_write(I2S_NUM_1, ibuffer, BUFFER_SIZE * 4, &bytesLength, portMAX_DELAY);
   }
   vTaskDelete(NULL);
@@ -180,6 +198,9 @@ void setupChirp()
   err = chirp_sdk_set_volume(chirp, VOLUME);
   chirpErrorHandler(err);
 
+  err = chirp_sdk_send_queue_init(&sendQueue, chirp);
+  chirpErrorHandler(err);
+
   Serial.println("Chirp SDK initialised.");
 }
 
@@ -207,9 +228,9 @@ void setupAudioOutput(int sample_rate)
   {
     .mode = i2s_mode_t(I2S_MODE_MASTER | I2S_MODE_TX),
     .sample_rate = sample_rate,
-    .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
+    .bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT,
     .channel_format = I2S_CHANNEL_FMT_ONLY_RIGHT,
-    .communication_format = i2s_comm_format_t(I2S_COMM_FORMAT_I2S | I2S_COMM_FORMAT_I2S_LSB),
+    .communication_format = i2s_comm_format_t(I2S_COMM_FORMAT_I2S | I2S_COMM_FORMAT_I2S_MSB),
     .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
     .dma_buf_count = 8,
     .dma_buf_len = 64,
@@ -16,6 +16,10 @@
     These buffers are read directly by the I2S peripheral to output
     audio data.
 
+    The I2S output runs at 44.1kHz, and the SDK synthesises the audio at half
+    that rate, which is then interpolated by `chirp_sdk_resampler_t`. This
+    saves CPU time on this board without a floating-point unit.
+
     *Note*: This board is send-only as it does not have a floating-point unit
     which is required to receive data.
 
@@ -40,6 +44,8 @@
 #include <Adafruit_ZeroDMA.h>
 
 #include "chirp_sdk.h"
+#include "chirp_sdk_audio.h"
+#include "chirp_sdk_resampler.h"
 #include "credentials.h"
 
 #define VOLUME            0.1  // Between 0 and 1
@@ -47,11 +53,11 @@
 #define NUM_BUFFERS       2
 #define BUFFER_SIZE       1024
 #define SAMPLE_RATE       44100
+#define RESAMPLE_FACTOR   2
 
 // Global variables ------------------------------------------------------------
 
-int buffer[NUM_BUFFERS][BUFFER_SIZE];
-short tmpBuffer[BUFFER_SIZE / 2];
+int32_t buffer[NUM_BUFFERS][BUFFER_SIZE];
 uint8_t nextBufferIndex, currentBufferIndex;
 
 Adafruit_ZeroI2S i2s;
@@ -59,6 +65,8 @@ Adafruit_ZeroDMA dma;
 DmacDescriptor  *desc;
 
 static chirp_sdk_t *chirp = NULL;
+static chirp_sdk_resampler_t resampler;
+static chirp_sdk_dac_output_t dacOutput;
 static volatile bool dma_complete = true;
 
 // Function definitions --------------------------------------------------------
@@ -101,18 +109,10 @@ void loop()
   {
     nextBufferIndex = (currentBufferIndex + 1) % NUM_BUFFERS;
 
-    // Process data in to the next mono buffer
-    chirp_sdk_error_code_t err = chirp_sdk_process_shorts_output(chirp, tmpBuffer, BUFFER_SIZE / 2);
+    // Process data straight into the next stereo buffer for audio output
+    chirp_sdk_error_code_t err = chirp_sdk_process_i32_output(chirp, &dacOutput, buffer[nextBufferIndex], BUFFER_SIZE / 2);
     chirpErrorHandler(err);
 
-    // Copy the data into a stereo buffer for audio output
-    for (int i = 0; i < BUFFER_SIZE / 2; i++)
-    {
-      int value = tmpBuffer[i] * INT16_MAX;
-      buffer[nextBufferIndex][i * 2] = value;
-      buffer[nextBufferIndex][i * 2 + 1] = value;
-    }
-
     dma_complete = false;
   }
 }
@@ -174,7 +174,17 @@ void setupChirp()
   err = chirp_sdk_set_callbacks(chirp, callback_set);
   chirpErrorHandler(err);
 
-  err = chirp_sdk_set_output_sample_rate(chirp, SAMPLE_RATE);
+  err = chirp_sdk_set_output_sample_rate(chirp, SAMPLE_RATE / RESAMPLE_FACTOR);
+  chirpErrorHandler(err);
+
+  err = chirp_sdk_resampler_init(&resampler, chirp, CHIRP_SDK_RESAMPLER_OUTPUT, RESAMPLE_FACTOR);
+  chirpErrorHandler(err);
+
+  // 32-bit stereo words, interpolated by the resampler
+  err = chirp_sdk_dac_output_init(&dacOutput, 32, 2, false);
+  chirpErrorHandler(err);
+
+  err = chirp_sdk_dac_output_set_resampler(&dacOutput, &resampler);
   chirpErrorHandler(err);
 
   err = chirp_sdk_set_volume(chirp, VOLUME);
@@ -22,6 +22,10 @@
  *  data sent as well as the length of the payload, in bytes, will be displayed.
  *  The audio data is sent via the 3.5mm jack output.
  *
+ *  The audio is moved between the AudioClass and the SDK by a
+ *  `chirp_sdk_pipeline_t`, with a ring of buffers in each direction, so that
+ *  the audio callbacks never wait for the main loop.
+ *
  *  See README.md for further information and known issues.
  *
  *  Copyright © 2011-2018, Asio Ltd.
@@ -42,6 +46,8 @@
  * the same folder.
  */
 #include "chirp_sdk.h"
+#include "chirp_sdk_pipeline.h"
+#include "chirp_sdk_pipeline_mxchip.h"
 #include "credentials.h"
 
 /*
@@ -50,17 +56,7 @@
  */
 #define SAMPLE_RATE 16000
 #define AUDIO_SAMPLE_SIZE 16
-#define SHORT_BUFFER_SIZE (AUDIO_CHUNK_SIZE / 2)
-#define FLOAT_BUFFER_SIZE (SHORT_BUFFER_SIZE / 2)
-
-/*
- * To keep track of audio buffer states.
- */
-typedef enum {
-  BUFFER_STATE_NONE,
-  BUFFER_STATE_EMPTY,
-  BUFFER_STATE_FULL,
-} bufferState;
+#define PIPELINE_BUFFERS 4
 
 /*
  * Class handling the audio on the board. The state is recording by default.
@@ -69,14 +65,12 @@ static AudioClass& Audio = AudioClass::getInstance();
 AUDIO_STATE_TypeDef audioState = AUDIO_STATE_RECORDING;
 
 /*
- * Buffers containnig the audio to play and record data.
+ * Rings of buffers containing the audio recorded and to play.
  */
-static int16_t shortRecordBuffer[SHORT_BUFFER_SIZE] = {0};
-static float floatRecordBuffer[FLOAT_BUFFER_SIZE] = {0};
-bufferState recordBufferState = BUFFER_STATE_EMPTY;
-
-static int16_t shortPlayBuffer[SHORT_BUFFER_SIZE] = {0};
-bufferState playBufferState = BUFFER_STATE_EMPTY;
+static short recordBuffers[PIPELINE_BUFFERS * CHIRP_SDK_PIPELINE_MXCHIP_BUFFER_LENGTH];
+static short playBuffers[PIPELINE_BUFFERS * CHIRP_SDK_PIPELINE_MXCHIP_BUFFER_LENGTH];
+static chirp_sdk_pipeline_t pipeline;
+static ChirpPipelineAudioClass audioPipeline(&pipeline, Audio);
 
 int lastButtonAState;
 int buttonAState;
@@ -122,8 +116,7 @@ void errorHandler(chirp_sdk_error_code_t errorCode)
  */
 void recordCallback(void)
 {
-    Audio.readFromRecordBuffer((char *) shortRecordBuffer, SHORT_BUFFER_SIZE * 2);
-    recordBufferState = BUFFER_STATE_FULL;
+    audioPipeline.recordCallback();
 }
 
 /*
@@ -132,11 +125,7 @@ void recordCallback(void)
  */
 void playCallback(void)
 {
-    if(playBufferState == BUFFER_STATE_FULL)
-    {
-        Audio.writeToPlayBuffer((char *) shortPlayBuffer, SHORT_BUFFER_SIZE * 2);
-        playBufferState = BUFFER_STATE_EMPTY;
-    }
+    audioPipeline.playCallback();
 }
 
 /*
@@ -260,6 +249,10 @@ void setup()
 
     printf("SDK started\n");
 
+    errorCode = chirp_sdk_pipeline_init(&pipeline, chirp, recordBuffers, playBuffers,
+                                        PIPELINE_BUFFERS, CHIRP_SDK_PIPELINE_MXCHIP_BUFFER_LENGTH);
+    errorHandler(errorCode);
+
     Screen.clean();
     Screen.print(0, "Chirp Arduino");
     Screen.print(1, "Listening ...");
@@ -303,50 +296,20 @@ void loop()
         rgbLed.turnOff();
     }
 
-    if (audioState == AUDIO_STATE_RECORDING)
+    // If the button B is pressed a chirp is sent.
+    if (audioState == AUDIO_STATE_PLAYING && buttonBState == LOW && lastButtonBState == HIGH)
     {
-        // Once the recording buffer is full, we process it.
-        if (recordBufferState == BUFFER_STATE_FULL)
-        {
-            // Convert the stereo audio samples into mono by taking every other sample and convert them
-            // from int16_t to float.
-            for (int i = 0; i < FLOAT_BUFFER_SIZE; i++)
-            {
-                floatRecordBuffer[i] = (float) shortRecordBuffer[i * 2] / 32767.0f;
-            }
-            errorCode = chirp_sdk_process_input(chirp, floatRecordBuffer, FLOAT_BUFFER_SIZE);
-            errorHandler(errorCode);
-            recordBufferState = BUFFER_STATE_EMPTY;
-        }
+        size_t randomPayloadLength = 0;
+        uint8_t *randomPayload =  chirp_sdk_random_payload(chirp, &randomPayloadLength);
+        errorCode = chirp_sdk_send(chirp, randomPayload, randomPayloadLength);
+        errorHandler(errorCode);
+        chirp_sdk_free(randomPayload);
     }
-    else if (audioState == AUDIO_STATE_PLAYING)
-    {
-        // If the button B is pressed a chirp is sent.
-        if (buttonBState == LOW && lastButtonBState == HIGH)
-        {
-            size_t randomPayloadLength = 0;
-            uint8_t *randomPayload =  chirp_sdk_random_payload(chirp, &randomPayloadLength);
-            errorCode = chirp_sdk_send(chirp, randomPayload, randomPayloadLength);
-            errorHandler(errorCode);
-            chirp_sdk_free(randomPayload);
-        }
 
-        chirp_sdk_state_t state = chirp_sdk_get_state(chirp);
-        if (state == CHIRP_SDK_STATE_SENDING && playBufferState == BUFFER_STATE_EMPTY)
-        {
-            float tmpBuffer[SHORT_BUFFER_SIZE / 2] = {0};
-            errorCode = chirp_sdk_process_output(chirp, tmpBuffer, SHORT_BUFFER_SIZE / 2);
-            errorHandler(errorCode);
-            // On the contrary of the recording part, we duplicate the data produced by the SDK
-            // to create a stereo audio stream that is converted from float to int16_t samples.
-            for (uint16_t i = 0; i < SHORT_BUFFER_SIZE / 2; i++)
-            {
-                shortPlayBuffer[i * 2] = tmpBuffer[i] * 32767.0f;
-                shortPlayBuffer[i * 2 + 1] = tmpBuffer[i] * 32767.0f;
-            }
-            playBufferState = BUFFER_STATE_FULL;
-        }
-    }
+    // Decode the buffers recorded and render the buffers played since the
+    // last loop. Only the ring of the current audio state is moving.
+    errorCode = chirp_sdk_pipeline_process(&pipeline);
+    errorHandler(errorCode);
 
     lastButtonAState = buttonAState;
     lastButtonBState = buttonBState;
@@ -12,6 +12,16 @@
     This example will start listening for chirps and print to the terminal
     when anything is received.
 
+    The PDM interrupt only copies the audio into a ring of buffers, which
+    the main loop decodes with `chirp_sdk_pipeline_process`. Decoding can
+    take several buffers' worth of time at the end of a chirp, and the ring
+    absorbs it without missing any audio.
+
+    The actual sample rate of the PDM microphone is slightly off 16kHz. It is
+    measured against the CPU clock by `chirp_sdk_monitor_t`, which keeps the
+    frequency correction of the SDK up to date. The estimate is printed with
+    each payload received, and can be saved to start from on the next boot.
+
     *Note*: this example can be used in conjunction with the send example,
     to send and receive data in the same application.
 
@@ -28,16 +38,26 @@
 #include <PDM.h>
 
 #include "chirp_sdk.h"
+#include "chirp_sdk_monitor.h"
+#include "chirp_sdk_pipeline.h"
+#include "chirp_sdk_pipeline_nrf.h"
 #include "credentials.h"
 
 #define SAMPLE_RATE       16000   // Audio sample rate
 #define BUFFER_SIZE       256     // Audio buffer size
+#define PIPELINE_BUFFERS  8       // Number of audio buffers in the ring
+
+// Starting point of the frequency correction, measured on a Nano 33 BLE Sense
+#define FREQUENCY_CORRECTION  1.00812
 
 // Global variables ------------------------------------------------------------
 
 static chirp_sdk_t *chirp = NULL;
-short sampleBuffer[BUFFER_SIZE];
-volatile int samplesRead;
+static chirp_sdk_monitor_t monitor;
+static short sampleBuffers[PIPELINE_BUFFERS * BUFFER_SIZE];
+static chirp_sdk_pipeline_t pipeline;
+static ChirpPipelinePDM pdmPipeline(&pipeline);
+static volatile size_t samplesReceived = 0;
 
 // Function definitions --------------------------------------------------------
 
@@ -71,19 +91,22 @@ void setup()
 
 void loop()
 {
-  if (samplesRead)
-  {
-    chirp_sdk_error_code_t err = chirp_sdk_process_shorts_input(chirp, sampleBuffer, samplesRead);
-    chirpErrorHandler(err);
-    samplesRead = 0;
-  }
+  noInterrupts();
+  size_t samples = samplesReceived;
+  samplesReceived = 0;
+  interrupts();
+
+  chirp_sdk_error_code_t err = chirp_sdk_monitor_input(&monitor, samples);
+  chirpErrorHandler(err);
+
+  err = chirp_sdk_pipeline_process(&pipeline);
+  chirpErrorHandler(err);
 }
 
 void onPDMdata()
 {
-  int bytesAvailable = PDM.available();
-  PDM.read(sampleBuffer, bytesAvailable);
-  samplesRead = bytesAvailable / sizeof(short);
+  samplesReceived += PDM.available() / sizeof(short);
+  pdmPipeline.onReceive();
 }
 
 // Chirp -----------------------------------------------------------------------
@@ -102,6 +125,9 @@ void onReceivedCallback(void *chirp, uint8_t *payload, size_t length, uint8_t ch
     Serial.print("Received data: ");
     Serial.println(data);
     free(data);
+
+    Serial.print("Frequency correction: ");
+    Serial.println(chirp_sdk_monitor_get_input_sample_rate_ratio(&monitor), 6);
   }
   else
   {
@@ -146,10 +172,20 @@ void setupChirp(void)
   err = chirp_sdk_set_input_sample_rate(chirp, SAMPLE_RATE);
   chirpErrorHandler(err);
 
-  // A fixed frequency correction coefficient is needed to correct a clock
-  // mismatch between the 16000Hz requested sample rate and the Nano's actual
-  // audio sample rate.
-  err = chirp_sdk_set_frequency_correction(chirp, 1.00812);
+  // The frequency correction corrects a clock mismatch between the 16000Hz
+  // requested sample rate and the Nano's actual audio sample rate. It is
+  // tracked from the samples received over time. The samples are counted
+  // from the main loop, so the tolerance covers the whole ring.
+  err = chirp_sdk_monitor_init(&monitor, chirp, NULL, (PIPELINE_BUFFERS + 2) * BUFFER_SIZE);
+  chirpErrorHandler(err);
+
+  err = chirp_sdk_monitor_set_frequency_tracking(&monitor, true);
+  chirpErrorHandler(err);
+
+  err = chirp_sdk_monitor_set_input_sample_rate_ratio(&monitor, FREQUENCY_CORRECTION);
+  chirpErrorHandler(err);
+
+  err = chirp_sdk_pipeline_init(&pipeline, chirp, sampleBuffers, NULL, PIPELINE_BUFFERS, BUFFER_SIZE);
   chirpErrorHandler(err);
 
   err = chirp_sdk_start(chirp);
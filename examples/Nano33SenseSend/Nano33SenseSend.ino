@@ -25,6 +25,7 @@
 
   ----------------------------------------------------------------------------*/
 #include "chirp_sdk.h"
+#include "chirp_sdk_audio.h"
 #include "credentials.h"
 
 #define VOLUME                 0.1  // Between 0 and 1
@@ -38,6 +39,7 @@
 // Global variables ------------------------------------------------------------
 
 static chirp_sdk_t *chirp = NULL;
+static chirp_sdk_dac_output_t dacOutput;
 short *currentBuffer;
 short buffer1[BUFFER_SIZE];
 short buffer2[BUFFER_SIZE];
@@ -74,7 +76,7 @@ void loop()
   if (NRF_I2S->EVENTS_TXPTRUPD != 0)
   {
     currentBuffer = currentBuffer == buffer1 ? buffer2 : buffer1;
-    chirp_sdk_error_code_t err = chirp_sdk_process_shorts_output(chirp, currentBuffer, BUFFER_SIZE);
+    chirp_sdk_error_code_t err = chirp_sdk_process_shorts_output_dithered(chirp, &dacOutput, currentBuffer, BUFFER_SIZE);
     chirpErrorHandler(err);
     NRF_I2S->TXD.PTR = (uint32_t)(currentBuffer);
     NRF_I2S->EVENTS_TXPTRUPD = 0;
@@ -136,6 +138,11 @@ void setupChirp(void)
   err = chirp_sdk_set_volume(chirp, VOLUME);
   chirpErrorHandler(err);
 
+  // At this low volume the 16-bit samples are dithered, so that the
+  // quantisation adds a flat noise floor rather than harmonics.
+  err = chirp_sdk_dac_output_init(&dacOutput, 16, 1, true);
+  chirpErrorHandler(err);
+
   err = chirp_sdk_start(chirp);
   chirpErrorHandler(err);
 
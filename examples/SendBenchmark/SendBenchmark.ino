@@ -0,0 +1,226 @@
+/**-----------------------------------------------------------------------------
+
+    Benchmark of the Chirp SDK encoder, synthesising audio for a 44.1kHz
+    DAC without any audio hardware.
+
+    @file SendBenchmark.ino
+
+    @brief Create a developer account at https://developers.chirp.io,
+    and copy and paste your key, secret and config string for the
+    "16khz-mono-embedded" protocol into the credentials.h file. Other
+    configs can be benchmarked by adding them to the `configs` array below.
+
+    For each config, payload length and output path, a random payload is
+    sent and the output is processed block by block until the SDK has sent
+    it. The output paths are :
+
+      - `process_shorts_44k` : the SDK synthesises every sample at 44.1kHz
+      - `resampler_44k` : the SDK synthesises at 22.05kHz, and
+        `chirp_sdk_resampler_t` interpolates to 44.1kHz with integer
+        arithmetic only
+      - `i32_stereo_44k` : as `resampler_44k`, written straight into 32-bit
+        stereo DAC words by `chirp_sdk_process_i32_output`, which is the
+        output path of the MKRZeroSend example
+
+    One line is printed per run, in CSV format :
+
+      config,path,payload,block,samples,us_per_block,cycles_per_sample,max_us_per_block,max_block_load,rtf
+
+    where `cycles_per_sample` is derived from the CPU clock (0 if F_CPU is
+    not defined by the board), `max_block_load` the longest block time
+    divided by the duration of a block, which must stay under 1, and `rtf`
+    the CPU time spent divided by the duration of the audio. The block sizes
+    and sample counts are at 44.1kHz.
+
+    The resampled paths synthesise half as many samples with the floating
+    point synthesiser of the SDK, which is what costs the most on the
+    cortex-m0plus boards, as they have no FPU. The audio is the same up to
+    the passband ripple of the resampler filter and its 16-bit rounding.
+    The Benchmark example checks that it still decodes on the boards which
+    can receive.
+
+    *Note*: This example runs on every board, including the send-only
+    cortex-m0plus boards (MKRZero, MKR Vidor 4000).
+
+    Copyright © 2011-2019, Asio Ltd.
+    All rights reserved.
+
+  ----------------------------------------------------------------------------*/
+#include "chirp_sdk.h"
+#include "chirp_sdk_audio.h"
+#include "chirp_sdk_resampler.h"
+#include "credentials.h"
+
+#define SAMPLE_RATE       44100
+#define RESAMPLE_FACTOR   2
+#define MAX_BUFFER_SIZE   512
+
+typedef enum {
+  PATH_PROCESS_SHORTS,
+  PATH_RESAMPLER,
+  PATH_I32_STEREO,
+  PATH_COUNT
+} outputPath_t;
+
+// Global variables ------------------------------------------------------------
+
+static const char *configs[] = { CHIRP_APP_CONFIG };
+static const size_t blockSizes[] = { 128, 512 };
+static const char *pathNames[PATH_COUNT] = { "process_shorts_44k", "resampler_44k", "i32_stereo_44k" };
+
+static short shortBuffer[MAX_BUFFER_SIZE];
+static int32_t wordBuffer[2 * MAX_BUFFER_SIZE];
+static chirp_sdk_resampler_t resampler;
+static chirp_sdk_dac_output_t dacOutput;
+
+// Function definitions --------------------------------------------------------
+
+void runBenchmark(size_t configIndex, outputPath_t path, size_t payloadLength, size_t blockSize);
+void chirpErrorHandler(chirp_sdk_error_code_t code);
+
+// Main ------------------------------------------------------------------------
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial);
+
+  Serial.print("Chirp SDK send benchmark - v");
+  Serial.print(chirp_sdk_get_version());
+  Serial.print(" [");
+  Serial.print(chirp_sdk_get_build_number());
+  Serial.println("]");
+
+  Serial.println("config,path,payload,block,samples,us_per_block,cycles_per_sample,max_us_per_block,max_block_load,rtf");
+
+  for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+  {
+    chirp_sdk_t *chirp = new_chirp_sdk(CHIRP_APP_KEY, CHIRP_APP_SECRET);
+    if (chirp == NULL)
+    {
+      Serial.println("Chirp initialisation failed.");
+      return;
+    }
+    chirpErrorHandler(chirp_sdk_set_config(chirp, configs[c]));
+    size_t maxLength = chirp_sdk_get_max_payload_length(chirp);
+    chirpErrorHandler(del_chirp_sdk(&chirp));
+
+    size_t payloadLengths[] = { 1, maxLength };
+    for (size_t p = 0; p < sizeof(payloadLengths) / sizeof(payloadLengths[0]); p++)
+    {
+      for (size_t b = 0; b < sizeof(blockSizes) / sizeof(blockSizes[0]); b++)
+      {
+        for (int m = 0; m < PATH_COUNT; m++)
+        {
+          runBenchmark(c, (outputPath_t) m, payloadLengths[p], blockSizes[b]);
+        }
+      }
+    }
+  }
+
+  Serial.println("Benchmark complete.");
+}
+
+void loop()
+{
+}
+
+// Benchmark -------------------------------------------------------------------
+
+void runBenchmark(size_t configIndex, outputPath_t path, size_t payloadLength, size_t blockSize)
+{
+  uint32_t sdkRate = path == PATH_PROCESS_SHORTS ? SAMPLE_RATE : SAMPLE_RATE / RESAMPLE_FACTOR;
+
+  chirp_sdk_t *chirp = new_chirp_sdk(CHIRP_APP_KEY, CHIRP_APP_SECRET);
+  if (chirp == NULL)
+  {
+    Serial.println("Chirp initialisation failed.");
+    return;
+  }
+
+  chirpErrorHandler(chirp_sdk_set_config(chirp, configs[configIndex]));
+  chirpErrorHandler(chirp_sdk_set_output_sample_rate(chirp, sdkRate));
+  chirpErrorHandler(chirp_sdk_start(chirp));
+
+  if (path != PATH_PROCESS_SHORTS)
+  {
+    chirpErrorHandler(chirp_sdk_resampler_init(&resampler, chirp, CHIRP_SDK_RESAMPLER_OUTPUT, RESAMPLE_FACTOR));
+    chirpErrorHandler(chirp_sdk_dac_output_init(&dacOutput, 32, 2, false));
+    chirpErrorHandler(chirp_sdk_dac_output_set_resampler(&dacOutput, &resampler));
+  }
+
+  size_t length = payloadLength;
+  uint8_t *payload = chirp_sdk_random_payload(chirp, &length);
+  chirpErrorHandler(chirp_sdk_send(chirp, payload, length));
+
+  size_t samples = 0;
+  size_t blocks = 0;
+  uint32_t elapsed = 0;
+  uint32_t maxElapsed = 0;
+
+  while (chirp_sdk_get_state(chirp) == CHIRP_SDK_STATE_SENDING)
+  {
+    uint32_t start = micros();
+    if (path == PATH_PROCESS_SHORTS)
+    {
+      chirpErrorHandler(chirp_sdk_process_shorts_output(chirp, shortBuffer, blockSize));
+    }
+    else if (path == PATH_RESAMPLER)
+    {
+      chirpErrorHandler(chirp_sdk_resampler_process_shorts_output(&resampler, shortBuffer, blockSize));
+    }
+    else
+    {
+      chirpErrorHandler(chirp_sdk_process_i32_output(chirp, &dacOutput, wordBuffer, blockSize));
+    }
+    uint32_t blockElapsed = micros() - start;
+    elapsed += blockElapsed;
+    if (blockElapsed > maxElapsed)
+    {
+      maxElapsed = blockElapsed;
+    }
+    samples += blockSize;
+    blocks++;
+  }
+
+  float seconds = elapsed / 1e6f;
+  Serial.print(configIndex);
+  Serial.print(",");
+  Serial.print(pathNames[path]);
+  Serial.print(",");
+  Serial.print(length);
+  Serial.print(",");
+  Serial.print(blockSize);
+  Serial.print(",");
+  Serial.print(samples);
+  Serial.print(",");
+  Serial.print(blocks ? (float) elapsed / blocks : 0.0f, 1);
+  Serial.print(",");
+#ifdef F_CPU
+  Serial.print(samples ? (float) elapsed / samples * (F_CPU / 1000000) : 0.0f, 1);
+#else
+  Serial.print(0);
+#endif
+  Serial.print(",");
+  Serial.print(maxElapsed);
+  Serial.print(",");
+  Serial.print(maxElapsed * (SAMPLE_RATE / 1e6f) / blockSize, 4);
+  Serial.print(",");
+  Serial.println(samples ? seconds * SAMPLE_RATE / samples : 0.0f, 4);
+
+  chirp_sdk_free(payload);
+  chirpErrorHandler(chirp_sdk_stop(chirp));
+  chirpErrorHandler(del_chirp_sdk(&chirp));
+}
+
+// Chirp -----------------------------------------------------------------------
+
+void chirpErrorHandler(chirp_sdk_error_code_t code)
+{
+  if (code != CHIRP_SDK_OK)
+  {
+    const char *error_string = chirp_sdk_error_code_to_string(code);
+    Serial.println(error_string);
+    exit(42);
+  }
+}
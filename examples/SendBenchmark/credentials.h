@@ -0,0 +1,21 @@
+/*------------------------------------------------------------------------------
+ *
+ *  Credentials.h
+ *
+ *  For full information on usage and licensing, see https://chirp.io/
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef Credentials_h
+#define Credentials_h
+
+#error("Add your credentials below (from https://developers.chirp.io) and delete this line.")
+
+#define CHIRP_APP_KEY        "YOUR_APP_KEY"
+#define CHIRP_APP_SECRET     "YOUR_APP_SECRET"
+#define CHIRP_APP_CONFIG     "YOUR_APP_CONFIG"
+
+#endif /* Credentials_h */
@@ -0,0 +1,166 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_stub.c
+ *
+ *  @brief Host stand-in for the prebuilt SDK, to test the modules built on
+ *         its public API.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "chirp_sdk_stub.h"
+
+int test_failures = 0;
+
+void stub_init(chirp_sdk_t *sdk)
+{
+    memset(sdk, 0, sizeof(*sdk));
+    sdk->state = CHIRP_SDK_STATE_RUNNING;
+    sdk->input_sample_rate = 16000;
+    sdk->output_sample_rate = 16000;
+    sdk->frequency_correction = 1.0f;
+    sdk->payload_samples = 1000;
+    sdk->random_state = 1;
+}
+
+static short next_noise(chirp_sdk_t *sdk)
+{
+    sdk->random_state ^= sdk->random_state << 13;
+    sdk->random_state ^= sdk->random_state >> 17;
+    sdk->random_state ^= sdk->random_state << 5;
+    return (short) (sdk->random_state >> 16);
+}
+
+chirp_sdk_state_t chirp_sdk_get_state(chirp_sdk_t *sdk)
+{
+    return sdk->state;
+}
+
+uint32_t chirp_sdk_get_input_sample_rate(chirp_sdk_t *sdk)
+{
+    return sdk->input_sample_rate;
+}
+
+uint32_t chirp_sdk_get_output_sample_rate(chirp_sdk_t *sdk)
+{
+    return sdk->output_sample_rate;
+}
+
+chirp_sdk_error_code_t chirp_sdk_set_listen_to_self(chirp_sdk_t *sdk, bool listen_to_self)
+{
+    sdk->listen_to_self = listen_to_self;
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_set_frequency_correction(chirp_sdk_t *sdk, float correction)
+{
+    sdk->frequency_correction = correction;
+    return CHIRP_SDK_OK;
+}
+
+float chirp_sdk_get_duration_for_payload_length(chirp_sdk_t *sdk, size_t payload_length)
+{
+    (void) payload_length;
+    return (float) sdk->payload_samples / sdk->output_sample_rate;
+}
+
+chirp_sdk_error_code_t chirp_sdk_is_valid(chirp_sdk_t *sdk, const uint8_t *bytes, size_t length)
+{
+    (void) sdk;
+    (void) bytes;
+    return length == 0 || length > 32 ? CHIRP_SDK_PAYLOAD_TOO_LONG : CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_send(chirp_sdk_t *sdk, uint8_t *bytes, size_t length)
+{
+    if (sdk->state == CHIRP_SDK_STATE_SENDING)
+        return CHIRP_SDK_ALREADY_SENDING;
+
+    if (sdk->sent_count < STUB_MAX_SENT)
+    {
+        memcpy(sdk->sent[sdk->sent_count], bytes, length);
+        sdk->sent_lengths[sdk->sent_count] = length;
+    }
+    sdk->sent_count++;
+    sdk->remaining = sdk->payload_samples;
+    sdk->state = CHIRP_SDK_STATE_SENDING;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_shorts_output(chirp_sdk_t *sdk, short *buffer, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (sdk->remaining > 0)
+        {
+            buffer[i] = next_noise(sdk);
+            if (--sdk->remaining == 0)
+                sdk->state = CHIRP_SDK_STATE_RUNNING;
+        }
+        else
+        {
+            buffer[i] = 0;
+        }
+    }
+    sdk->output_samples += length;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_output(chirp_sdk_t *sdk, float *buffer, size_t length)
+{
+    short chunk[64];
+
+    while (length > 0)
+    {
+        size_t count = length < 64 ? length : 64;
+        chirp_sdk_process_shorts_output(sdk, chunk, count);
+        for (size_t i = 0; i < count; i++)
+            buffer[i] = chunk[i] / 32768.0f;
+        buffer += count;
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_shorts_input(chirp_sdk_t *sdk, const short *buffer, size_t length)
+{
+    if (sdk->on_input)
+        sdk->on_input(sdk->ptr, buffer, length);
+    sdk->input_samples += length;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_input(chirp_sdk_t *sdk, float *buffer, size_t length)
+{
+    short chunk[64];
+
+    while (length > 0)
+    {
+        size_t count = length < 64 ? length : 64;
+        for (size_t i = 0; i < count; i++)
+            chunk[i] = (short) (buffer[i] * 32767.0f);
+        chirp_sdk_process_shorts_input(sdk, chunk, count);
+        buffer += count;
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+const char *chirp_sdk_error_code_to_string(chirp_sdk_error_code_t err)
+{
+    return err == CHIRP_SDK_OK ? "No error." : "Error of the core.";
+}
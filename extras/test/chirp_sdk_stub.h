@@ -0,0 +1,75 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_stub.h
+ *
+ *  @brief Host stand-in for the prebuilt SDK, to test the modules built on
+ *         its public API.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_STUB_H
+#define CHIRP_SDK_STUB_H
+
+#include <stdio.h>
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STUB_MAX_SENT 16
+
+/*
+ * Called with every block of audio given to the decoder.
+ */
+typedef void (*stub_input_t)(void *ptr, const short *buffer, size_t length);
+
+/*
+ * State of the stand-in. Sending a payload produces `payload_samples`
+ * samples of full scale noise, and silence otherwise. Nothing is decoded.
+ */
+struct _chirp_sdk_t {
+    chirp_sdk_state_t state;
+    uint32_t input_sample_rate;
+    uint32_t output_sample_rate;
+    bool listen_to_self;
+    float frequency_correction;
+    size_t payload_samples;
+    size_t remaining;
+    uint32_t random_state;
+    size_t input_samples;
+    size_t output_samples;
+    stub_input_t on_input;
+    void *ptr;
+    size_t sent_count;
+    size_t sent_lengths[STUB_MAX_SENT];
+    uint8_t sent[STUB_MAX_SENT][32];
+};
+
+void stub_init(chirp_sdk_t *sdk);
+
+extern int test_failures;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) \
+        { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_STUB_H */
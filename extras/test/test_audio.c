@@ -0,0 +1,141 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file test_audio.c
+ *
+ *  @brief Tests of the audio format helpers.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "chirp_sdk_audio.h"
+#include "chirp_sdk_stub.h"
+
+static chirp_sdk_t sdk;
+
+static void test_render_short_buffer(void)
+{
+    uint8_t payload[4] = {0};
+    short buffer[1000];
+    size_t rendered = 1;
+
+    stub_init(&sdk);
+    CHECK(chirp_sdk_get_render_length(&sdk, sizeof(payload)) == 1000);
+
+    CHECK(chirp_sdk_render_shorts(&sdk, payload, sizeof(payload), buffer, 999, &rendered) == CHIRP_SDK_BUFFER_TOO_SHORT);
+    CHECK(rendered == 0);
+    CHECK(sdk.sent_count == 0);
+    CHECK(strcmp(chirp_sdk_module_error_code_to_string(CHIRP_SDK_BUFFER_TOO_SHORT),
+                 "The buffer is shorter than the length required.") == 0);
+    CHECK(strcmp(chirp_sdk_module_error_code_to_string(CHIRP_SDK_OK), "No error.") == 0);
+
+    CHECK(chirp_sdk_render_shorts(&sdk, payload, sizeof(payload), buffer, 1000, &rendered) == CHIRP_SDK_OK);
+    CHECK(rendered == 1000);
+    CHECK(sdk.state == CHIRP_SDK_STATE_RUNNING);
+}
+
+static void test_no_dither_through_resampler(void)
+{
+    uint8_t payload[4] = {0};
+    chirp_sdk_resampler_t resampler;
+    chirp_sdk_dac_output_t output;
+    static short dithered[2000];
+    static short plain[2000];
+
+    /*
+     * The resampler quantises to 16 bits, so enabling the dither must not
+     * change its output.
+     */
+    for (int dither = 0; dither < 2; dither++)
+    {
+        stub_init(&sdk);
+        chirp_sdk_resampler_init(&resampler, &sdk, CHIRP_SDK_RESAMPLER_OUTPUT, 2);
+        chirp_sdk_dac_output_init(&output, 16, 1, dither);
+        chirp_sdk_dac_output_set_resampler(&output, &resampler);
+
+        chirp_sdk_send(&sdk, payload, sizeof(payload));
+        chirp_sdk_process_shorts_output_dithered(&sdk, &output, dither ? dithered : plain, 2000);
+    }
+    CHECK(memcmp(dithered, plain, sizeof(plain)) == 0);
+
+    /*
+     * Straight from the SDK, the dither changes the rounding of some samples.
+     */
+    for (int dither = 0; dither < 2; dither++)
+    {
+        stub_init(&sdk);
+        chirp_sdk_dac_output_init(&output, 16, 1, dither);
+
+        chirp_sdk_send(&sdk, payload, sizeof(payload));
+        chirp_sdk_process_shorts_output_dithered(&sdk, &output, dither ? dithered : plain, 1000);
+    }
+    CHECK(memcmp(dithered, plain, 1000 * sizeof(short)) != 0);
+}
+
+static void test_i32_output_through_resampler(void)
+{
+    uint8_t payload[4] = {0};
+    chirp_sdk_resampler_t resampler;
+    chirp_sdk_dac_output_t output;
+    static short expected[2000];
+    static int32_t words[4000];
+
+    stub_init(&sdk);
+    chirp_sdk_resampler_init(&resampler, &sdk, CHIRP_SDK_RESAMPLER_OUTPUT, 2);
+    chirp_sdk_send(&sdk, payload, sizeof(payload));
+    chirp_sdk_resampler_process_shorts_output(&resampler, expected, 2000);
+
+    /*
+     * The 16-bit samples of the resampler are shifted into the top of the
+     * DAC words, on every channel, whatever the bit depth and dither.
+     */
+    stub_init(&sdk);
+    chirp_sdk_resampler_init(&resampler, &sdk, CHIRP_SDK_RESAMPLER_OUTPUT, 2);
+    chirp_sdk_dac_output_init(&output, 24, 2, true);
+    chirp_sdk_dac_output_set_resampler(&output, &resampler);
+    chirp_sdk_send(&sdk, payload, sizeof(payload));
+    CHECK(chirp_sdk_process_i32_output(&sdk, &output, words, 2000) == CHIRP_SDK_OK);
+
+    for (size_t i = 0; i < 2000; i++)
+    {
+        CHECK(words[2 * i] == (int32_t) ((uint32_t) (uint16_t) expected[i] << 16));
+        CHECK(words[2 * i + 1] == words[2 * i]);
+    }
+}
+
+static void test_i32_input_negative_offset(void)
+{
+    chirp_sdk_i32_input_t input;
+    int32_t words[256];
+    short samples[256];
+
+    /*
+     * A microphone with a negative DC offset primes the filter with a
+     * negative value, which is removed from the first sample on.
+     */
+    for (size_t i = 0; i < 256; i++)
+        words[i] = (int32_t) ((uint32_t) -1000 << 14);
+
+    chirp_sdk_i32_input_init(&input, 18, 0);
+    CHECK(chirp_sdk_i32_input_convert(&input, words, samples, 256) == CHIRP_SDK_OK);
+    for (size_t i = 0; i < 256; i++)
+        CHECK(samples[i] == 0);
+}
+
+int main(void)
+{
+    test_i32_input_negative_offset();
+    test_render_short_buffer();
+    test_no_dither_through_resampler();
+    test_i32_output_through_resampler();
+
+    return test_failures ? 1 : 0;
+}
@@ -0,0 +1,209 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file test_duplex.c
+ *
+ *  @brief Tests of `chirp_sdk_duplex_t`, against a simulated echo path.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include "chirp_sdk_duplex.h"
+#include "chirp_sdk_stub.h"
+
+#define BLOCK_SIZE 256
+#define ECHO_DELAY 320
+#define HISTORY (1 << 20)
+
+static const float echo_path[] = {0.1f, 0.04f, -0.03f, 0.016f, 0.006f};
+
+static chirp_sdk_t sdk;
+static chirp_sdk_duplex_t duplex;
+static short played[HISTORY];
+static short received[HISTORY];
+static short cleaned[HISTORY];
+static float near_end[HISTORY];
+static size_t position;
+static size_t cleaned_length;
+static uint32_t random_state;
+
+static void record(void *ptr, const short *buffer, size_t length)
+{
+    (void) ptr;
+    memcpy(cleaned + cleaned_length, buffer, length * sizeof(short));
+    cleaned_length += length;
+}
+
+static void setup(uint32_t delay)
+{
+    stub_init(&sdk);
+    sdk.on_input = record;
+    sdk.payload_samples = HISTORY;
+    position = 0;
+    cleaned_length = 0;
+    random_state = 1;
+    chirp_sdk_duplex_init(&duplex, &sdk, delay);
+}
+
+typedef enum {
+    NEAR_END_SILENT,
+    NEAR_END_TONE,
+    NEAR_END_NOISE
+} near_end_t;
+
+/*
+ * Send continuously and feed back the echo of the audio played, with a
+ * near-end signal added, up to `end` samples.
+ */
+static void run(size_t end, near_end_t near)
+{
+    uint8_t payload[4] = {0};
+
+    if (chirp_sdk_get_state(&sdk) != CHIRP_SDK_STATE_SENDING)
+        chirp_sdk_send(&sdk, payload, sizeof(payload));
+
+    for (; position < end; position += BLOCK_SIZE)
+    {
+        short *input = received + position;
+
+        chirp_sdk_duplex_process_shorts_output(&duplex, played + position, BLOCK_SIZE);
+
+        for (size_t i = 0; i < BLOCK_SIZE; i++)
+        {
+            size_t n = position + i;
+            float echo = 0;
+            for (size_t k = 0; k < sizeof(echo_path) / sizeof(echo_path[0]); k++)
+            {
+                if (n >= ECHO_DELAY + k)
+                    echo += echo_path[k] * played[n - ECHO_DELAY - k];
+            }
+
+            if (near == NEAR_END_TONE)
+            {
+                near_end[n] = 1000.0f * sinf(n * 0.05f);
+            }
+            else if (near == NEAR_END_NOISE)
+            {
+                random_state = random_state * 1103515245u + 12345u;
+                near_end[n] = ((int32_t) ((random_state >> 8) & 0xffff) - 32768) * 0.6f;
+            }
+            else
+            {
+                near_end[n] = 0;
+            }
+
+            float value = echo + near_end[n];
+            input[i] = value > 32767.0f ? 32767 : value < -32768.0f ? -32768 : (short) lrintf(value);
+        }
+
+        chirp_sdk_duplex_process_shorts_input(&duplex, input, BLOCK_SIZE);
+    }
+}
+
+/*
+ * Ratio, in dB, of the power of the echo to what is left of it in `audio`,
+ * between `start` and `end` samples.
+ */
+static double echo_ratio(const short *audio, size_t start, size_t end)
+{
+    double echo = 0;
+    double residual = 0;
+
+    for (size_t n = start; n < end; n++)
+    {
+        double error = audio[n] - near_end[n];
+        echo += (received[n] - near_end[n]) * (double) (received[n] - near_end[n]);
+        residual += error * error;
+    }
+
+    return 10.0 * log10(echo / (residual + 1e-9));
+}
+
+static void test_echo_cancelled(void)
+{
+    setup(ECHO_DELAY - 20);
+    run(80000, NEAR_END_SILENT);
+
+    float erle = chirp_sdk_duplex_get_erle(&duplex);
+    printf("  echo: ERLE %.1fdB\n", erle);
+    CHECK(erle > 40.0f);
+}
+
+static void test_near_end_recovered(void)
+{
+    setup(ECHO_DELAY - 20);
+    run(80000, NEAR_END_TONE);
+
+    /*
+     * The tone is 10dB below the echo in the input, and disturbs the
+     * adaptation, which leaves more of the echo than with no near end.
+     */
+    double attenuation = echo_ratio(cleaned, 48000, 80000);
+    printf("  near end: echo attenuated by %.1fdB\n", attenuation);
+    CHECK(attenuation > 20.0);
+}
+
+static void test_delay_search(void)
+{
+    static const uint32_t delays[] = {0, 200, 1000, CHIRP_SDK_DUPLEX_MAX_DELAY};
+
+    for (size_t i = 0; i < sizeof(delays) / sizeof(delays[0]); i++)
+    {
+        setup(delays[i]);
+        run(240000, NEAR_END_SILENT);
+
+        uint32_t delay = chirp_sdk_duplex_get_delay(&duplex);
+        float erle = chirp_sdk_duplex_get_erle(&duplex);
+        printf("  delay from %u: found %u, ERLE %.1fdB\n", delays[i], delay, erle);
+        CHECK(delay <= ECHO_DELAY && delay + CHIRP_SDK_DUPLEX_TAPS > ECHO_DELAY);
+        CHECK(erle > 40.0f);
+    }
+}
+
+static double double_talk(float threshold)
+{
+    setup(ECHO_DELAY - 20);
+    chirp_sdk_duplex_set_double_talk_threshold(&duplex, threshold);
+
+    run(48000, NEAR_END_SILENT);
+    run(64000, NEAR_END_NOISE);
+    size_t end = position;
+    run(end + 4096, NEAR_END_SILENT);
+
+    /*
+     * Echo left just after the other device stops.
+     */
+    return echo_ratio(cleaned, end, end + 4096);
+}
+
+static void test_double_talk(void)
+{
+    /*
+     * The near-end noise is louder than the echo, which goes through a gain
+     * of about 0.2, so it is detected with a threshold of 0.25.
+     */
+    double detected = double_talk(0.25f);
+    double undetected = double_talk(0);
+    printf("  double talk: echo attenuated by %.1fdB, %.1fdB without detection\n", detected, undetected);
+    CHECK(detected > 40.0);
+    CHECK(detected > undetected + 20.0);
+}
+
+int main(void)
+{
+    test_echo_cancelled();
+    test_near_end_recovered();
+    test_delay_search();
+    test_double_talk();
+
+    return test_failures ? 1 : 0;
+}
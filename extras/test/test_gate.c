@@ -0,0 +1,138 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file test_gate.c
+ *
+ *  @brief Tests of `chirp_sdk_gate_t`.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+
+#include "chirp_sdk_gate.h"
+#include "chirp_sdk_stub.h"
+
+#define BLOCK_LENGTH 256
+#define LOOKBACK_LENGTH (2 * BLOCK_LENGTH)
+
+static chirp_sdk_t sdk;
+static chirp_sdk_gate_t gate;
+static short lookback[LOOKBACK_LENGTH];
+static short buffer[BLOCK_LENGTH];
+static uint32_t random_state;
+static uint32_t phase;
+
+static void setup(void)
+{
+    stub_init(&sdk);
+    random_state = 1;
+    phase = 0;
+    chirp_sdk_gate_init(&gate, &sdk, lookback, LOOKBACK_LENGTH, 1000, 4000);
+}
+
+/*
+ * Process a block of white noise of amplitude `noise`, with a 2kHz tone of
+ * amplitude `tone` standing for a chirp.
+ */
+static chirp_sdk_gate_state_t process(float noise, float tone)
+{
+    for (size_t i = 0; i < BLOCK_LENGTH; i++)
+    {
+        random_state = random_state * 1103515245u + 12345u;
+        float value = noise * (((random_state >> 8) & 0xffff) / 32768.0f - 1.0f);
+        value += tone * sinf(2.0f * 3.14159265f * 2000.0f * phase++ / 16000.0f);
+        buffer[i] = (short) value;
+    }
+
+    chirp_sdk_gate_process_shorts_input(&gate, buffer, BLOCK_LENGTH);
+    return chirp_sdk_gate_get_state(&gate);
+}
+
+static void test_open_on_chirp(void)
+{
+    setup();
+
+    for (int i = 0; i < 100; i++)
+        CHECK(process(100, 0) == CHIRP_SDK_GATE_CLOSED);
+    CHECK(sdk.input_samples == 0);
+
+    /*
+     * The lookback is decoded first, so the start of the chirp is not lost.
+     */
+    CHECK(process(100, 1000) == CHIRP_SDK_GATE_OPEN);
+    CHECK(sdk.input_samples == LOOKBACK_LENGTH + BLOCK_LENGTH);
+}
+
+static void test_close_after_hold_time(void)
+{
+    uint32_t hold_blocks = (uint32_t) (CHIRP_SDK_GATE_DEFAULT_HOLD_TIME * 16000) / BLOCK_LENGTH;
+
+    setup();
+    for (int i = 0; i < 100; i++)
+        process(100, 0);
+    for (int i = 0; i < 20; i++)
+        CHECK(process(100, 1000) == CHIRP_SDK_GATE_OPEN);
+
+    for (uint32_t i = 0; i < hold_blocks; i++)
+        CHECK(process(100, 0) == CHIRP_SDK_GATE_OPEN);
+    CHECK(process(100, 0) == CHIRP_SDK_GATE_CLOSED);
+
+    /*
+     * The gate is held open while the SDK is receiving, whatever the energy.
+     */
+    process(100, 1000);
+    sdk.state = CHIRP_SDK_STATE_RECEIVING;
+    for (uint32_t i = 0; i < 3 * hold_blocks; i++)
+        CHECK(process(100, 0) == CHIRP_SDK_GATE_OPEN);
+    sdk.state = CHIRP_SDK_STATE_RUNNING;
+    for (uint32_t i = 0; i <= hold_blocks; i++)
+        process(100, 0);
+    CHECK(chirp_sdk_gate_get_state(&gate) == CHIRP_SDK_GATE_CLOSED);
+}
+
+static void test_noise_floor_rising(void)
+{
+    int closed_at = -1;
+    int reopened = 0;
+
+    setup();
+    for (int i = 0; i < 500; i++)
+        process(100, 0);
+
+    /*
+     * The ambient noise rises by 20dB for good. The gate opens, and closes
+     * again once the noise floor has caught up.
+     */
+    for (int i = 500; i < 2000; i++)
+    {
+        chirp_sdk_gate_state_t state = process(1000, 0);
+        if (state == CHIRP_SDK_GATE_CLOSED && closed_at < 0)
+            closed_at = i;
+        else if (state == CHIRP_SDK_GATE_OPEN && closed_at >= 0)
+            reopened++;
+    }
+    printf("  noise floor rising: closed again at block %d, %d blocks open since\n", closed_at, reopened);
+    CHECK(closed_at > 500 && closed_at < 1000);
+    CHECK(reopened == 0);
+
+    /*
+     * A chirp over the new noise floor still opens the gate.
+     */
+    CHECK(process(1000, 6000) == CHIRP_SDK_GATE_OPEN);
+}
+
+int main(void)
+{
+    test_open_on_chirp();
+    test_close_after_hold_time();
+    test_noise_floor_rising();
+
+    return test_failures ? 1 : 0;
+}
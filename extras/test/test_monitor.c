@@ -0,0 +1,158 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file test_monitor.c
+ *
+ *  @brief Tests of `chirp_sdk_monitor_t`, against a simulated clock.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+
+#include "chirp_sdk_monitor.h"
+#include "chirp_sdk_stub.h"
+
+#define BLOCK_LENGTH 256
+
+/*
+ * Ratio between the actual and nominal sample rates of the PDM microphone
+ * of a Nano 33 BLE Sense.
+ */
+#define RATIO 1.00812
+
+static chirp_sdk_t sdk;
+static chirp_sdk_monitor_t monitor;
+static unsigned long now;
+static uint32_t random_state = 1;
+
+static unsigned long test_clock(void)
+{
+    return now;
+}
+
+/*
+ * Delay, in microseconds, between a block being recorded and being
+ * accounted, up to a block. Blocks are accounted in order.
+ */
+static unsigned long jitter(void)
+{
+    random_state = random_state * 1103515245u + 12345u;
+    return (random_state >> 8) % (BLOCK_LENGTH * 1000000 / 16000);
+}
+
+/*
+ * Account for the blocks recorded over `seconds`, skipping the first `lost`
+ * of them, and then one in every `interval` if not 0.
+ */
+static void record(double *time, double seconds, int lost, int interval)
+{
+    int count = 0;
+
+    double period = BLOCK_LENGTH / (16000.0 * RATIO);
+    double end = *time + seconds;
+
+    while (*time < end)
+    {
+        *time += period;
+        unsigned long accounted = (unsigned long) (*time * 1e6) + jitter();
+        if (accounted > now)
+            now = accounted;
+        if (lost > 0)
+            lost--;
+        else if (interval > 0 && ++count % interval == 0)
+            continue;
+        else
+            chirp_sdk_monitor_input(&monitor, BLOCK_LENGTH);
+    }
+}
+
+static void test_drifting_clock(void)
+{
+    chirp_sdk_monitor_stats_t stats;
+    double time = 0;
+
+    stub_init(&sdk);
+    now = 0;
+    chirp_sdk_monitor_init(&monitor, &sdk, test_clock, 2 * BLOCK_LENGTH);
+    chirp_sdk_monitor_set_frequency_tracking(&monitor, true);
+
+    record(&time, 120, 0, 0);
+
+    float ratio = chirp_sdk_monitor_get_input_sample_rate_ratio(&monitor);
+    chirp_sdk_monitor_get_stats(&monitor, &stats);
+    printf("  drift: ratio %.5f, correction %.5f, %u discontinuities\n",
+           ratio, sdk.frequency_correction, stats.input_discontinuities);
+    CHECK(fabs(ratio - RATIO) < 0.0002);
+    CHECK(fabs(sdk.frequency_correction - RATIO) < 0.0003);
+    CHECK(stats.input_discontinuities == 0);
+    CHECK(stats.input_overruns == 0);
+
+    /*
+     * A lost burst of audio is reported once, and does not move the
+     * estimate.
+     */
+    record(&time, 60, 8, 0);
+
+    ratio = chirp_sdk_monitor_get_input_sample_rate_ratio(&monitor);
+    chirp_sdk_monitor_get_stats(&monitor, &stats);
+    printf("  overrun: ratio %.5f, %u overruns\n", ratio, stats.input_overruns);
+    CHECK(fabs(ratio - RATIO) < 0.0002);
+    CHECK(stats.input_overruns == 1);
+    CHECK(stats.input_discontinuities == 0);
+
+    /*
+     * One block in ten lost is not mistaken for the clock drifting, and
+     * neither the estimate nor the correction follow it.
+     */
+    record(&time, 60, 0, 10);
+
+    ratio = chirp_sdk_monitor_get_input_sample_rate_ratio(&monitor);
+    chirp_sdk_monitor_get_stats(&monitor, &stats);
+    printf("  periodic loss: ratio %.5f, correction %.5f, %u overruns\n",
+           ratio, sdk.frequency_correction, stats.input_overruns);
+    CHECK(fabs(ratio - RATIO) < 0.0002);
+    CHECK(fabs(sdk.frequency_correction - RATIO) < 0.0003);
+    CHECK(stats.input_overruns > 100);
+    CHECK(stats.input_discontinuities == 0);
+}
+
+static void test_periodic_loss_from_start(void)
+{
+    chirp_sdk_monitor_stats_t stats;
+    double time = 0;
+
+    stub_init(&sdk);
+    now = 0;
+    chirp_sdk_monitor_init(&monitor, &sdk, test_clock, 2 * BLOCK_LENGTH);
+    chirp_sdk_monitor_set_frequency_tracking(&monitor, true);
+
+    /*
+     * The losses are reported from the start rather than learnt as a 10%
+     * slower clock, and the ratio is left at its nominal value.
+     */
+    record(&time, 120, 0, 10);
+
+    float ratio = chirp_sdk_monitor_get_input_sample_rate_ratio(&monitor);
+    chirp_sdk_monitor_get_stats(&monitor, &stats);
+    printf("  periodic loss from start: ratio %.5f, correction %.5f, %u overruns\n",
+           ratio, sdk.frequency_correction, stats.input_overruns);
+    CHECK(ratio == 1.0f);
+    CHECK(sdk.frequency_correction == 1.0f);
+    CHECK(stats.input_overruns > 200);
+    CHECK(stats.input_discontinuities == 0);
+}
+
+int main(void)
+{
+    test_drifting_clock();
+    test_periodic_loss_from_start();
+
+    return test_failures ? 1 : 0;
+}
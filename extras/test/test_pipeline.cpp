@@ -0,0 +1,198 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file test_pipeline.cpp
+ *
+ *  @brief Tests of `chirp_sdk_pipeline_t`, driven by `ChirpPipelineMock`.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "chirp_sdk_pipeline.h"
+#include "chirp_sdk_pipeline_mock.h"
+#include "chirp_sdk_stub.h"
+
+#define BUFFER_COUNT 4
+#define BUFFER_LENGTH 64
+
+static chirp_sdk_t sdk;
+static chirp_sdk_pipeline_t pipeline;
+static short inputBuffers[BUFFER_COUNT * BUFFER_LENGTH];
+static short outputBuffers[BUFFER_COUNT * BUFFER_LENGTH];
+static short played[BUFFER_LENGTH];
+
+static void record(void *ptr, const short *buffer, size_t length)
+{
+    std::vector<short> *decoded = (std::vector<short> *) ptr;
+    decoded->insert(decoded->end(), buffer, buffer + length);
+}
+
+static void setup(void)
+{
+    stub_init(&sdk);
+    chirp_sdk_pipeline_init(&pipeline, &sdk, inputBuffers, outputBuffers, BUFFER_COUNT, BUFFER_LENGTH);
+}
+
+static void test_loopback(void)
+{
+    std::vector<short> decoded;
+    std::vector<short> playedAll;
+    uint8_t payload[4] = {0};
+
+    setup();
+    sdk.on_input = record;
+    sdk.ptr = &decoded;
+    ChirpPipelineMock mock(&pipeline, played, true);
+
+    chirp_sdk_send(&sdk, payload, sizeof(payload));
+    for (int i = 0; i < 40; i++)
+    {
+        const short *buffer = mock.tick();
+        playedAll.insert(playedAll.end(), buffer, buffer + BUFFER_LENGTH);
+        CHECK(chirp_sdk_pipeline_process(&pipeline) == CHIRP_SDK_OK);
+    }
+
+    /*
+     * The ring starts full of silence, so the payload is played after
+     * BUFFER_COUNT buffers, and every sample played is decoded in order.
+     */
+    CHECK(decoded == playedAll);
+    for (size_t i = 0; i < BUFFER_COUNT * BUFFER_LENGTH; i++)
+        CHECK(playedAll[i] == 0);
+    CHECK(playedAll[BUFFER_COUNT * BUFFER_LENGTH] != 0);
+    CHECK(sdk.output_samples == 40 * BUFFER_LENGTH);
+
+    chirp_sdk_pipeline_stats_t stats;
+    chirp_sdk_pipeline_get_stats(&pipeline, &stats);
+    CHECK(stats.input_overruns == 0);
+    CHECK(stats.output_underruns == 0);
+}
+
+static void test_no_loopback(void)
+{
+    std::vector<short> decoded;
+    std::vector<short> playedAll;
+    uint8_t payload[4] = {0};
+
+    setup();
+    sdk.on_input = record;
+    sdk.ptr = &decoded;
+    ChirpPipelineMock mock(&pipeline, played, false);
+
+    chirp_sdk_send(&sdk, payload, sizeof(payload));
+    for (int i = 0; i < 40; i++)
+    {
+        const short *buffer = mock.tick();
+        playedAll.insert(playedAll.end(), buffer, buffer + BUFFER_LENGTH);
+        CHECK(chirp_sdk_pipeline_process(&pipeline) == CHIRP_SDK_OK);
+    }
+
+    /*
+     * The payload is still returned as played, while only silence is
+     * recorded.
+     */
+    CHECK(playedAll[BUFFER_COUNT * BUFFER_LENGTH] != 0);
+    CHECK(decoded.size() == playedAll.size());
+    for (size_t i = 0; i < decoded.size(); i++)
+        CHECK(decoded[i] == 0);
+}
+
+static void test_stalled_application(void)
+{
+    setup();
+    ChirpPipelineMock mock(&pipeline, played, false);
+
+    /*
+     * The application stalls for 3 buffers longer than the rings absorb.
+     */
+    for (int i = 0; i < BUFFER_COUNT + 3; i++)
+        mock.tick();
+
+    chirp_sdk_pipeline_stats_t stats;
+    chirp_sdk_pipeline_get_stats(&pipeline, &stats);
+    CHECK(stats.input_overruns == 3);
+    CHECK(stats.output_underruns == 3);
+
+    CHECK(chirp_sdk_pipeline_process(&pipeline) == CHIRP_SDK_OK);
+    CHECK(sdk.input_samples == BUFFER_COUNT * BUFFER_LENGTH);
+    CHECK(sdk.output_samples == BUFFER_COUNT * BUFFER_LENGTH);
+
+    /*
+     * Both rings recover as soon as the application catches up.
+     */
+    for (int i = 0; i < 10; i++)
+    {
+        mock.tick();
+        chirp_sdk_pipeline_process(&pipeline);
+    }
+
+    chirp_sdk_pipeline_get_stats(&pipeline, &stats);
+    CHECK(stats.input_overruns == 3);
+    CHECK(stats.output_underruns == 3);
+    CHECK(sdk.input_samples == (BUFFER_COUNT + 10) * BUFFER_LENGTH);
+}
+
+static void test_concurrent_driver(void)
+{
+    const uint32_t ticks = 20000;
+    std::atomic<bool> done(false);
+
+    setup();
+    ChirpPipelineMock mock(&pipeline, played, false);
+
+    /*
+     * The driver runs in its own thread, as it would in an interrupt, while
+     * the application processes the rings with stalls of random length,
+     * some longer than the rings absorb. Every buffer is either processed
+     * or counted as an overrun or underrun.
+     */
+    std::thread driver([&]() {
+        for (uint32_t i = 0; i < ticks; i++)
+        {
+            mock.tick();
+            std::this_thread::yield();
+        }
+        done.store(true);
+    });
+
+    uint32_t random = 1;
+    while (!done.load())
+    {
+        chirp_sdk_pipeline_process(&pipeline);
+
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        for (uint32_t i = random % (2 * BUFFER_COUNT); i > 0; i--)
+            std::this_thread::yield();
+    }
+    driver.join();
+    chirp_sdk_pipeline_process(&pipeline);
+
+    chirp_sdk_pipeline_stats_t stats;
+    chirp_sdk_pipeline_get_stats(&pipeline, &stats);
+    printf("  concurrent: %u ticks, %u overruns, %u underruns\n", ticks, stats.input_overruns, stats.output_underruns);
+    CHECK(mock.getTicks() == ticks);
+    CHECK(sdk.input_samples == (ticks - stats.input_overruns) * BUFFER_LENGTH);
+    CHECK(sdk.output_samples == (ticks - stats.output_underruns) * BUFFER_LENGTH);
+}
+
+int main(void)
+{
+    test_loopback();
+    test_no_loopback();
+    test_stalled_application();
+    test_concurrent_driver();
+
+    return test_failures ? 1 : 0;
+}
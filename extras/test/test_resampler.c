@@ -0,0 +1,131 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file test_resampler.c
+ *
+ *  @brief Tests of `chirp_sdk_resampler_t`, measuring the response of its
+ *         low-pass filter.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+
+#include "chirp_sdk_resampler.h"
+#include "chirp_sdk_stub.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FREQUENCY_STEPS 2000
+
+static chirp_sdk_t sdk;
+
+/*
+ * Gain, in dB relative to DC, of the prototype filter at a frequency given
+ * as a fraction of the hardware sample rate.
+ */
+static double gain(const double *filter, int length, double frequency)
+{
+    double re = 0, im = 0, dc = 0;
+    for (int i = 0; i < length; i++)
+    {
+        re += filter[i] * cos(2 * M_PI * frequency * i);
+        im -= filter[i] * sin(2 * M_PI * frequency * i);
+        dc += filter[i];
+    }
+    return 20 * log10(sqrt(re * re + im * im) / fabs(dc) + 1e-12);
+}
+
+/*
+ * Rebuild the prototype filter from the coefficients, which are stored with
+ * their phases contiguous for the output.
+ */
+static int prototype(const chirp_sdk_resampler_t *resampler, double *filter)
+{
+    int length = resampler->factor * CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE;
+    for (int i = 0; i < length; i++)
+    {
+        int index = i;
+        if (resampler->direction == CHIRP_SDK_RESAMPLER_OUTPUT)
+            index = (i % resampler->factor) * CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE + i / resampler->factor;
+        filter[i] = resampler->coefficients[index];
+    }
+    return length;
+}
+
+static void test_filter_response(chirp_sdk_resampler_direction_t direction)
+{
+    static chirp_sdk_resampler_t resampler;
+    double filter[CHIRP_SDK_RESAMPLER_MAX_TAPS];
+
+    for (uint8_t factor = 2; factor <= CHIRP_SDK_RESAMPLER_MAX_FACTOR; factor++)
+    {
+        chirp_sdk_resampler_init(&resampler, &sdk, direction, factor);
+        int length = prototype(&resampler, filter);
+        double nyquist = 0.5 / factor;
+        double ripple = 0;
+        double stopband = -1000;
+
+        for (int k = 0; k <= FREQUENCY_STEPS; k++)
+        {
+            double frequency = 0.5 * k / FREQUENCY_STEPS;
+            double db = gain(filter, length, frequency);
+            if (frequency <= 0.8 * nyquist && fabs(db) > ripple)
+                ripple = fabs(db);
+            if (frequency >= 1.2 * nyquist && db > stopband)
+                stopband = db;
+        }
+
+        printf("  %s x%u: passband ripple %.3fdB, stopband %.1fdB\n",
+               direction == CHIRP_SDK_RESAMPLER_INPUT ? "input" : "output", factor, ripple, stopband);
+        CHECK(ripple < 0.05);
+        CHECK(stopband < -59.5);
+    }
+}
+
+/*
+ * The output resampler keeps the level of the audio.
+ */
+static void test_output_gain(void)
+{
+    static chirp_sdk_resampler_t resampler;
+    static short buffer[4000];
+
+    stub_init(&sdk);
+    sdk.payload_samples = 100000;
+    chirp_sdk_send(&sdk, (uint8_t *) "", 1);
+    chirp_sdk_resampler_init(&resampler, &sdk, CHIRP_SDK_RESAMPLER_OUTPUT, 2);
+    chirp_sdk_resampler_process_shorts_output(&resampler, buffer, 4000);
+
+    double power = 0;
+    for (int i = 1000; i < 4000; i++)
+        power += (double) buffer[i] * buffer[i];
+    power /= 3000;
+
+    /*
+     * The noise is white up to the processing Nyquist frequency, and its
+     * images above it are removed, so the power of full scale uniform noise
+     * is kept, less the transition band and some clipping of the peaks.
+     */
+    double expected = 32768.0 * 32768.0 / 3;
+    printf("  output x2: gain %.2fdB\n", 10 * log10(power / expected));
+    CHECK(fabs(10 * log10(power / expected)) < 1.0);
+}
+
+int main(void)
+{
+    stub_init(&sdk);
+    test_filter_response(CHIRP_SDK_RESAMPLER_INPUT);
+    test_filter_response(CHIRP_SDK_RESAMPLER_OUTPUT);
+    test_output_gain();
+
+    return test_failures ? 1 : 0;
+}
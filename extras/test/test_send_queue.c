@@ -0,0 +1,130 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file test_send_queue.c
+ *
+ *  @brief Tests of `chirp_sdk_send_queue_t`.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include "chirp_sdk_send_queue.h"
+#include "chirp_sdk_stub.h"
+
+static chirp_sdk_t sdk;
+static chirp_sdk_send_queue_t queue;
+static short buffer[256];
+
+static void test_full_queue(void)
+{
+    uint8_t payload[4] = {0};
+
+    stub_init(&sdk);
+    chirp_sdk_send_queue_init(&queue, &sdk);
+
+    for (uint8_t i = 0; i < CHIRP_SDK_SEND_QUEUE_SIZE; i++)
+    {
+        payload[0] = i;
+        CHECK(chirp_sdk_send_queue_push(&queue, payload, sizeof(payload)) == CHIRP_SDK_OK);
+    }
+    CHECK(chirp_sdk_send_queue_push(&queue, payload, sizeof(payload)) == CHIRP_SDK_ALREADY_SENDING);
+    CHECK(chirp_sdk_send_queue_get_depth(&queue) == CHIRP_SDK_SEND_QUEUE_SIZE);
+}
+
+static void test_push_after_flushing_full_queue(void)
+{
+    uint8_t payload[4] = {0};
+
+    stub_init(&sdk);
+    chirp_sdk_send_queue_init(&queue, &sdk);
+
+    for (uint8_t i = 0; i < CHIRP_SDK_SEND_QUEUE_SIZE; i++)
+        chirp_sdk_send_queue_push(&queue, payload, sizeof(payload));
+
+    CHECK(chirp_sdk_send_queue_flush(&queue) == CHIRP_SDK_OK);
+    CHECK(chirp_sdk_send_queue_get_depth(&queue) == 0);
+
+    CHECK(chirp_sdk_send_queue_process_shorts_output(&queue, buffer, 256) == CHIRP_SDK_OK);
+    CHECK(sdk.sent_count == 0);
+
+    for (uint8_t i = 0; i < CHIRP_SDK_SEND_QUEUE_SIZE; i++)
+    {
+        payload[0] = 10 + i;
+        CHECK(chirp_sdk_send_queue_push(&queue, payload, sizeof(payload)) == CHIRP_SDK_OK);
+    }
+    CHECK(chirp_sdk_send_queue_get_depth(&queue) == CHIRP_SDK_SEND_QUEUE_SIZE);
+
+    for (int i = 0; i < 100 && chirp_sdk_send_queue_get_depth(&queue) > 0; i++)
+        chirp_sdk_send_queue_process_shorts_output(&queue, buffer, 256);
+
+    CHECK(sdk.sent_count == CHIRP_SDK_SEND_QUEUE_SIZE);
+    for (uint8_t i = 0; i < CHIRP_SDK_SEND_QUEUE_SIZE; i++)
+        CHECK(sdk.sent[i][0] == 10 + i);
+}
+
+static void test_flush_while_sending(void)
+{
+    uint8_t payload[4] = {0};
+
+    stub_init(&sdk);
+    chirp_sdk_send_queue_init(&queue, &sdk);
+
+    for (uint8_t i = 0; i < CHIRP_SDK_SEND_QUEUE_SIZE; i++)
+    {
+        payload[0] = i;
+        chirp_sdk_send_queue_push(&queue, payload, sizeof(payload));
+    }
+    chirp_sdk_send_queue_process_shorts_output(&queue, buffer, 256);
+    CHECK(sdk.sent_count == 1);
+    CHECK(chirp_sdk_send_queue_get_depth(&queue) == CHIRP_SDK_SEND_QUEUE_SIZE - 1);
+
+    chirp_sdk_send_queue_flush(&queue);
+    chirp_sdk_send_queue_process_shorts_output(&queue, buffer, 256);
+    CHECK(sdk.state == CHIRP_SDK_STATE_SENDING);
+
+    for (uint8_t i = 0; i < CHIRP_SDK_SEND_QUEUE_SIZE; i++)
+        CHECK(chirp_sdk_send_queue_push(&queue, payload, sizeof(payload)) == CHIRP_SDK_OK);
+    CHECK(chirp_sdk_send_queue_push(&queue, payload, sizeof(payload)) == CHIRP_SDK_ALREADY_SENDING);
+    CHECK(sdk.sent_count == 1);
+}
+
+static void test_back_to_back(void)
+{
+    uint8_t payload[4] = {0};
+
+    stub_init(&sdk);
+    chirp_sdk_send_queue_init(&queue, &sdk);
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        payload[0] = i;
+        chirp_sdk_send_queue_push(&queue, payload, sizeof(payload));
+    }
+
+    /*
+     * The second payload starts within a slice of the end of the first one.
+     */
+    while (sdk.sent_count < 2)
+        chirp_sdk_send_queue_process_shorts_output(&queue, buffer, 256);
+
+    size_t start = sdk.output_samples - (sdk.payload_samples - sdk.remaining);
+    CHECK(start >= sdk.payload_samples);
+    CHECK(start - sdk.payload_samples <= CHIRP_SDK_SEND_QUEUE_SLICE_SIZE);
+    CHECK(sdk.sent[1][0] == 1);
+}
+
+int main(void)
+{
+    test_full_queue();
+    test_push_after_flushing_full_queue();
+    test_flush_while_sending();
+    test_back_to_back();
+
+    return test_failures ? 1 : 0;
+}
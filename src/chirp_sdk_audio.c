@@ -0,0 +1,491 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_audio.c
+ *
+ *  @brief Audio format helpers feeding the SDK straight from the buffers
+ *         used by the audio peripherals.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include "chirp_sdk_audio.h"
+
+static inline short saturate_short(int64_t value)
+{
+    if (value > INT16_MAX)
+        return INT16_MAX;
+    if (value < INT16_MIN)
+        return INT16_MIN;
+    return (short) value;
+}
+
+/*
+ * Xorshift generator, from "Xorshift RNGs" by George Marsaglia.
+ */
+static inline uint32_t next_random(chirp_sdk_dac_output_t *output)
+{
+    uint32_t x = output->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    output->random_state = x;
+    return x;
+}
+
+/*
+ * Round a sample scaled to the output word, saturating to [-max - 1, max].
+ * The TPDF dither is the difference of two uniform draws of 1 LSB, both
+ * taken from a single random word.
+ */
+static inline int32_t quantise(chirp_sdk_dac_output_t *output, float value, int32_t max)
+{
+    if (output->dither)
+    {
+        uint32_t r = next_random(output);
+        value += ((int32_t) (r & 0xffff) - (int32_t) (r >> 16)) * (1.0f / 65536.0f);
+    }
+
+    if (value >= (float) max)
+        return max;
+    if (value <= (float) -max - 1.0f)
+        return -max - 1;
+    return (int32_t) lrintf(value);
+}
+
+/*
+ * Render a chunk of mono 16-bit samples from the resampler, which are
+ * already quantised and are written to the DAC words without going through
+ * floating point.
+ */
+static chirp_sdk_error_code_t render_resampled_i32(chirp_sdk_dac_output_t *output, int32_t *buffer, size_t length)
+{
+    short chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+    const uint8_t channel_count = output->channel_count;
+
+    while (length > 0)
+    {
+        size_t count = length < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+
+        chirp_sdk_error_code_t err = chirp_sdk_resampler_process_shorts_output(output->resampler, chunk, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            int32_t word = (int32_t) ((uint32_t) (uint16_t) chunk[i] << 16);
+            for (uint8_t c = 0; c < channel_count; c++)
+                *buffer++ = word;
+        }
+
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+/*
+ * Render a chunk of mono 16-bit samples from the resampler as they are.
+ */
+static chirp_sdk_error_code_t render_resampled_shorts(chirp_sdk_dac_output_t *output, short *buffer, size_t length)
+{
+    short chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+    const uint8_t channel_count = output->channel_count;
+
+    while (length > 0)
+    {
+        size_t count = length < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+
+        chirp_sdk_error_code_t err = chirp_sdk_resampler_process_shorts_output(output->resampler, chunk, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            for (uint8_t c = 0; c < channel_count; c++)
+                *buffer++ = chunk[i];
+        }
+
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_i32_input_init(chirp_sdk_i32_input_t *input, uint8_t bit_depth, uint8_t gain)
+{
+    if (!input)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (bit_depth < 16)
+        bit_depth = 16;
+    if (bit_depth > 32)
+        bit_depth = 32;
+    if (gain > 16)
+        gain = 16;
+
+    input->bit_depth = bit_depth;
+    input->gain = gain;
+    input->primed = false;
+    input->dc_accumulator = 0;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_i32_input_convert(chirp_sdk_i32_input_t *input, const int32_t *buffer, short *output, size_t length)
+{
+    if (!input)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer || !output)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    const uint8_t word_shift = 32 - input->bit_depth;
+    const int8_t sample_shift = input->bit_depth - 16 - input->gain;
+    int64_t dc_accumulator = input->dc_accumulator;
+
+    if (!input->primed && length > 0)
+    {
+        dc_accumulator = (int64_t) (buffer[0] >> word_shift) * ((int64_t) 1 << CHIRP_SDK_DC_FILTER_SHIFT);
+        input->primed = true;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        int32_t sample = buffer[i] >> word_shift;
+        dc_accumulator += sample - (dc_accumulator >> CHIRP_SDK_DC_FILTER_SHIFT);
+        int64_t value = sample - (dc_accumulator >> CHIRP_SDK_DC_FILTER_SHIFT);
+        if (sample_shift >= 0)
+            output[i] = saturate_short(value >> sample_shift);
+        else
+            output[i] = saturate_short(value * ((int64_t) 1 << -sample_shift));
+    }
+
+    input->dc_accumulator = dc_accumulator;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_i32_input(chirp_sdk_t *sdk, chirp_sdk_i32_input_t *input, const int32_t *buffer, size_t length)
+{
+    if (!input)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    short chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+
+    while (length > 0)
+    {
+        size_t count = length < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+
+        chirp_sdk_i32_input_convert(input, buffer, chunk, count);
+
+        chirp_sdk_error_code_t err = chirp_sdk_process_shorts_input(sdk, chunk, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        buffer += count;
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_input_strided(chirp_sdk_t *sdk, const float *buffer, size_t length, size_t stride)
+{
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    /*
+     * The input buffer is not written to, despite the prototype.
+     */
+    if (stride == 1)
+        return chirp_sdk_process_input(sdk, (float *) buffer, length);
+
+    float chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+
+    while (length > 0)
+    {
+        size_t count = length < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            chunk[i] = buffer[i * stride];
+        }
+
+        chirp_sdk_error_code_t err = chirp_sdk_process_input(sdk, chunk, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        buffer += count * stride;
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_shorts_input_strided(chirp_sdk_t *sdk, const short *buffer, size_t length, size_t stride)
+{
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    if (stride == 1)
+        return chirp_sdk_process_shorts_input(sdk, buffer, length);
+
+    short chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+
+    while (length > 0)
+    {
+        size_t count = length < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            chunk[i] = buffer[i * stride];
+        }
+
+        chirp_sdk_error_code_t err = chirp_sdk_process_shorts_input(sdk, chunk, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        buffer += count * stride;
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_output_interleaved(chirp_sdk_t *sdk, float *buffer, size_t length, uint8_t channel_count)
+{
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    /*
+     * The mono signal is rendered at the start of the buffer and spread
+     * backwards, so that no sample is overwritten before it has been copied.
+     */
+    chirp_sdk_error_code_t err = chirp_sdk_process_output(sdk, buffer, length);
+    if (err != CHIRP_SDK_OK || channel_count <= 1)
+        return err;
+
+    for (size_t i = length; i-- > 0;)
+    {
+        float sample = buffer[i];
+        for (uint8_t c = channel_count; c-- > 0;)
+        {
+            buffer[i * channel_count + c] = sample;
+        }
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_shorts_output_interleaved(chirp_sdk_t *sdk, short *buffer, size_t length, uint8_t channel_count)
+{
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    chirp_sdk_error_code_t err = chirp_sdk_process_shorts_output(sdk, buffer, length);
+    if (err != CHIRP_SDK_OK || channel_count <= 1)
+        return err;
+
+    /*
+     * Stereo frames are written as single packed words when the buffer is
+     * word aligned, halving the number of stores. On cortex-m4 the packing
+     * compiles to a single PKHBT instruction.
+     */
+    if (channel_count == 2 && ((uintptr_t) buffer & 3) == 0)
+    {
+        for (size_t i = length; i-- > 0;)
+        {
+            uint32_t sample = (uint16_t) buffer[i];
+            uint32_t frame = sample | (sample << 16);
+            memcpy(__builtin_assume_aligned(buffer + i * 2, 4), &frame, sizeof(frame));
+        }
+        return CHIRP_SDK_OK;
+    }
+
+    for (size_t i = length; i-- > 0;)
+    {
+        short sample = buffer[i];
+        for (uint8_t c = channel_count; c-- > 0;)
+        {
+            buffer[i * channel_count + c] = sample;
+        }
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_dac_output_init(chirp_sdk_dac_output_t *output, uint8_t bit_depth, uint8_t channel_count, bool dither)
+{
+    if (!output)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (bit_depth < 16)
+        bit_depth = 16;
+    if (bit_depth > 32)
+        bit_depth = 32;
+    if (channel_count < 1)
+        channel_count = 1;
+    if (channel_count > 8)
+        channel_count = 8;
+
+    output->bit_depth = bit_depth;
+    output->channel_count = channel_count;
+    output->dither = dither;
+    output->random_state = 0x9e3779b9;
+    output->resampler = NULL;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_dac_output_set_resampler(chirp_sdk_dac_output_t *output, chirp_sdk_resampler_t *resampler)
+{
+    if (!output)
+        return CHIRP_SDK_NULL_POINTER;
+
+    output->resampler = resampler;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_i32_output(chirp_sdk_t *sdk, chirp_sdk_dac_output_t *output, int32_t *buffer, size_t length)
+{
+    if (!output)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+    if (output->resampler)
+        return render_resampled_i32(output, buffer, length);
+
+    float chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+    const uint8_t word_shift = 32 - output->bit_depth;
+    const int32_t max = (int32_t) (((uint32_t) 1 << (output->bit_depth - 1)) - 1);
+    const float scale = (float) max + 1.0f;
+    const uint8_t channel_count = output->channel_count;
+
+    while (length > 0)
+    {
+        size_t count = length < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+
+        chirp_sdk_error_code_t err = chirp_sdk_process_output(sdk, chunk, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            int32_t word = (int32_t) ((uint32_t) quantise(output, chunk[i] * scale, max) << word_shift);
+            for (uint8_t c = 0; c < channel_count; c++)
+                *buffer++ = word;
+        }
+
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_process_shorts_output_dithered(chirp_sdk_t *sdk, chirp_sdk_dac_output_t *output, short *buffer, size_t length)
+{
+    if (!output)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+    if (output->resampler)
+        return render_resampled_shorts(output, buffer, length);
+
+    float chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+    const uint8_t channel_count = output->channel_count;
+
+    while (length > 0)
+    {
+        size_t count = length < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+
+        chirp_sdk_error_code_t err = chirp_sdk_process_output(sdk, chunk, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            short sample = (short) quantise(output, chunk[i] * 32768.0f, INT16_MAX);
+            for (uint8_t c = 0; c < channel_count; c++)
+                *buffer++ = sample;
+        }
+
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+size_t chirp_sdk_get_render_length(chirp_sdk_t *sdk, size_t payload_length)
+{
+    float duration = chirp_sdk_get_duration_for_payload_length(sdk, payload_length);
+    if (duration <= 0)
+        return 0;
+
+    return (size_t) ceilf(duration * chirp_sdk_get_output_sample_rate(sdk));
+}
+
+chirp_sdk_error_code_t chirp_sdk_render_shorts(chirp_sdk_t *sdk, const uint8_t *bytes, size_t length, short *buffer, size_t buffer_length, size_t *rendered_length)
+{
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+    if (!rendered_length)
+        return CHIRP_SDK_NULL_POINTER;
+
+    *rendered_length = 0;
+
+    size_t render_length = chirp_sdk_get_render_length(sdk, length);
+    if (render_length > buffer_length)
+        return CHIRP_SDK_BUFFER_TOO_SHORT;
+
+    chirp_sdk_error_code_t err = chirp_sdk_send(sdk, (uint8_t *) bytes, length);
+    if (err != CHIRP_SDK_OK)
+        return err;
+
+    size_t offset = 0;
+    while (offset < render_length && chirp_sdk_get_state(sdk) == CHIRP_SDK_STATE_SENDING)
+    {
+        size_t count = render_length - offset;
+        if (count > CHIRP_SDK_AUDIO_CHUNK_SIZE)
+            count = CHIRP_SDK_AUDIO_CHUNK_SIZE;
+
+        err = chirp_sdk_process_shorts_output(sdk, buffer + offset, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        offset += count;
+    }
+
+    /*
+     * The duration reported by the SDK is the length of the waveform, so
+     * this is not expected. Flush anything left so that the SDK is not left
+     * sending into the live output.
+     */
+    if (chirp_sdk_get_state(sdk) == CHIRP_SDK_STATE_SENDING)
+    {
+        short chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+        while (chirp_sdk_get_state(sdk) == CHIRP_SDK_STATE_SENDING)
+        {
+            err = chirp_sdk_process_shorts_output(sdk, chunk, CHIRP_SDK_AUDIO_CHUNK_SIZE);
+            if (err != CHIRP_SDK_OK)
+                return err;
+        }
+        *rendered_length = offset;
+        return CHIRP_SDK_PROCESSING_ERROR;
+    }
+
+    *rendered_length = offset;
+
+    return CHIRP_SDK_OK;
+}
@@ -0,0 +1,285 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_audio.h
+ *
+ *  @brief Audio format helpers feeding the SDK straight from the buffers
+ *         used by the audio peripherals.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_AUDIO_H
+#define CHIRP_SDK_AUDIO_H
+
+#include "chirp_sdk.h"
+#include "chirp_sdk_module_errors.h"
+#include "chirp_sdk_resampler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of samples converted at a time on the stack before being handed to
+ * the SDK. This bounds the scratch memory used by the functions below to a
+ * few hundred bytes, whatever the length of the buffers given.
+ */
+#ifndef CHIRP_SDK_AUDIO_CHUNK_SIZE
+#define CHIRP_SDK_AUDIO_CHUNK_SIZE 64
+#endif
+
+/**
+ * Time constant, as a power of two in samples, of the DC offset removal
+ * applied to the 32-bit input. The default of 2^10 samples has a cut-off
+ * of about 2.5Hz at 16kHz.
+ */
+#ifndef CHIRP_SDK_DC_FILTER_SHIFT
+#define CHIRP_SDK_DC_FILTER_SHIFT 10
+#endif
+
+/**
+ * State of the 32-bit input conversion. It holds the format of the words
+ * read from the audio peripheral and the running DC offset estimate, and
+ * must be initialised with `chirp_sdk_i32_input_init`.
+ */
+typedef struct {
+    uint8_t bit_depth; ///< Number of significant bits, left-justified, in each word.
+    uint8_t gain; ///< Gain, in bits, applied once the DC offset has been removed.
+    bool primed; ///< Set once the DC offset has been seeded by the first sample.
+    int64_t dc_accumulator; ///< DC offset estimate, scaled by 2^CHIRP_SDK_DC_FILTER_SHIFT.
+} chirp_sdk_i32_input_t;
+
+/**
+ * State of the output conversion to the native words of a DAC. It holds the
+ * format of the words written to the audio peripheral and the state of the
+ * dither, and must be initialised with `chirp_sdk_dac_output_init`.
+ */
+typedef struct {
+    uint8_t bit_depth; ///< Number of significant bits, left-justified, in each 32-bit word.
+    uint8_t channel_count; ///< Number of interleaved channels the signal is written to.
+    bool dither; ///< Whether TPDF dither is added before the samples are quantised.
+    uint32_t random_state; ///< State of the pseudo-random generator of the dither.
+    chirp_sdk_resampler_t *resampler; ///< Output resampler the audio is rendered through, or NULL.
+} chirp_sdk_dac_output_t;
+
+/**
+ * Initialise the 32-bit input conversion state.
+ *
+ * @param input     A pointer to the state to initialise.
+ * @param bit_depth The number of significant bits in each left-justified word,
+ *                  between 16 and 32. For example 18 for a SPH0645 microphone
+ *                  or 24 for an ICS-43434. The remaining low bits are ignored.
+ *                  Values out of range are clamped.
+ * @param gain      Gain, in bits, applied to the samples before they are
+ *                  reduced to 16 bits, between 0 and 16. Samples are saturated
+ *                  rather than wrapped if the gain is too high. Values out of
+ *                  range are clamped.
+ * @return          An error code resulting from the call. CHIRP_SDK_OK will
+ *                  be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_i32_input_init(chirp_sdk_i32_input_t *input, uint8_t bit_depth, uint8_t gain);
+
+/**
+ * Convert left-justified 32-bit words to 16-bit samples, removing the DC
+ * offset and applying the gain of the input conversion state. This is the
+ * conversion done by `chirp_sdk_process_i32_input`, for drivers which hand
+ * the samples over to the decoder later, such as `chirp_sdk_pipeline_t`.
+ *
+ * @param input  A pointer to the 32-bit input conversion state.
+ * @param buffer The buffer containing mono left-justified 32-bit words.
+ * @param output The buffer filled with the 16-bit samples.
+ * @param length The length, in mono samples, of both buffers.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_i32_input_convert(chirp_sdk_i32_input_t *input, const int32_t *buffer, short *output, size_t length);
+
+/**
+ * 32-bit audio processing function for the decoding (input). The buffer can
+ * be the one filled by the I2S peripheral, it is not modified. The DC offset of
+ * the microphone is tracked and removed so no calibration value is needed.
+ *
+ * @param sdk    A pointer to the SDK structure.
+ * @param input  A pointer to the 32-bit input conversion state.
+ * @param buffer The input buffer containing mono left-justified 32-bit words
+ *               which will be decoded.
+ * @param length The length, in mono samples, of the input buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_process_i32_input(chirp_sdk_t *sdk, chirp_sdk_i32_input_t *input, const int32_t *buffer, size_t length);
+
+/**
+ * Float audio processing function for the decoding (input) of one channel of
+ * an interleaved buffer. For a stereo buffer, pass `buffer` for the left
+ * channel or `buffer + 1` for the right channel with a stride of 2.
+ *
+ * @param sdk    A pointer to the SDK structure.
+ * @param buffer The input buffer containing the first sample to be decoded.
+ * @param length The length, in samples of the decoded channel, of the input
+ *               buffer.
+ * @param stride The distance, in samples, between two consecutive samples of
+ *               the decoded channel. A stride of 1 is a mono buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_process_input_strided(chirp_sdk_t *sdk, const float *buffer, size_t length, size_t stride);
+
+/**
+ * Short audio processing function for the decoding (input) of one channel of
+ * an interleaved buffer. See `chirp_sdk_process_input_strided`.
+ *
+ * @param sdk    A pointer to the SDK structure.
+ * @param buffer The input buffer containing the first sample to be decoded.
+ * @param length The length, in samples of the decoded channel, of the input
+ *               buffer.
+ * @param stride The distance, in samples, between two consecutive samples of
+ *               the decoded channel. A stride of 1 is a mono buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_process_shorts_input_strided(chirp_sdk_t *sdk, const short *buffer, size_t length, size_t stride);
+
+/**
+ * Float audio processing function for the encoding (output) into an
+ * interleaved buffer. The same signal is written to every channel, in place,
+ * without any intermediate buffer.
+ *
+ * @param sdk           A pointer to the SDK structure.
+ * @param buffer        The output buffer which will be filled with
+ *                      `length * channel_count` new samples.
+ * @param length        The length, in frames, of the output buffer.
+ * @param channel_count The number of interleaved channels, 1 for mono.
+ * @return              An error code resulting from the call. CHIRP_SDK_OK
+ *                      will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_process_output_interleaved(chirp_sdk_t *sdk, float *buffer, size_t length, uint8_t channel_count);
+
+/**
+ * Short audio processing function for the encoding (output) into an
+ * interleaved buffer. See `chirp_sdk_process_output_interleaved`.
+ *
+ * @param sdk           A pointer to the SDK structure.
+ * @param buffer        The output buffer which will be filled with
+ *                      `length * channel_count` new samples.
+ * @param length        The length, in frames, of the output buffer.
+ * @param channel_count The number of interleaved channels, 1 for mono.
+ * @return              An error code resulting from the call. CHIRP_SDK_OK
+ *                      will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_process_shorts_output_interleaved(chirp_sdk_t *sdk, short *buffer, size_t length, uint8_t channel_count);
+
+/**
+ * Initialise the output conversion state.
+ *
+ * @param output        A pointer to the state to initialise.
+ * @param bit_depth     The number of significant bits in each left-justified
+ *                      32-bit word, between 16 and 32. For example 24 for a
+ *                      24-in-32 DAC. The remaining low bits are set to 0.
+ *                      Values out of range are clamped.
+ * @param channel_count The number of interleaved channels the signal is
+ *                      written to, between 1 and 8. For example 2 for a
+ *                      stereo DAC. Values out of range are clamped.
+ * @param dither        Whether triangular dither of 1 LSB is added before the
+ *                      samples are quantised, which turns the quantisation
+ *                      distortion into a constant noise floor. It is worth
+ *                      enabling at low `chirp_sdk_set_volume` levels, mostly
+ *                      for 16-bit words.
+ * @return              An error code resulting from the call. CHIRP_SDK_OK
+ *                      will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_dac_output_init(chirp_sdk_dac_output_t *output, uint8_t bit_depth, uint8_t channel_count, bool dither);
+
+/**
+ * Render the audio through an output resampler instead of straight from the
+ * SDK, so that it is synthesised at a lower sample rate than the DAC's. The
+ * 16-bit samples of the resampler are then shifted into the output words in
+ * integer arithmetic, without dither, and the SDK given to the output
+ * functions is not used.
+ *
+ * @param output    A pointer to the output conversion state.
+ * @param resampler A pointer to an output resampler, or NULL to render from
+ *                  the SDK.
+ * @return          An error code resulting from the call. CHIRP_SDK_OK will
+ *                  be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_dac_output_set_resampler(chirp_sdk_dac_output_t *output, chirp_sdk_resampler_t *resampler);
+
+/**
+ * 32-bit audio processing function for the encoding (output). The audio is
+ * synthesised straight into the words of the DAC, which can be the buffer
+ * read by the I2S peripheral, with the signal duplicated on every channel.
+ *
+ * @param sdk    A pointer to the SDK structure.
+ * @param output A pointer to the output conversion state.
+ * @param buffer The output buffer which will be filled with
+ *               `length * channel_count` left-justified 32-bit words.
+ * @param length The length, in frames, of the output buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_process_i32_output(chirp_sdk_t *sdk, chirp_sdk_dac_output_t *output, int32_t *buffer, size_t length);
+
+/**
+ * Short audio processing function for the encoding (output), with the
+ * channels and dither of an output conversion state. The bit depth of the
+ * state is not used, the samples are 16-bit.
+ *
+ * @param sdk    A pointer to the SDK structure.
+ * @param output A pointer to the output conversion state.
+ * @param buffer The output buffer which will be filled with
+ *               `length * channel_count` samples.
+ * @param length The length, in frames, of the output buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_process_shorts_output_dithered(chirp_sdk_t *sdk, chirp_sdk_dac_output_t *output, short *buffer, size_t length);
+
+/**
+ * Get the length, in samples at the output sample rate, of the waveform
+ * rendered by `chirp_sdk_render_shorts` for a given payload length.
+ *
+ * @param sdk            A pointer to the SDK structure.
+ * @param payload_length The length, in bytes, of the payload.
+ * @return               The length of the waveform in mono samples, or 0 if
+ *                       the payload length is not valid for the config.
+ */
+PUBLIC_SYM size_t chirp_sdk_get_render_length(chirp_sdk_t *sdk, size_t payload_length);
+
+/**
+ * Render the waveform of a payload once into a buffer, at the output sample
+ * rate and volume of the SDK. The buffer can then be played as many times as
+ * needed, for example by DMA, with no further processing. It can also be
+ * copied into a const array to be stored in flash.
+ *
+ * The SDK must be running and not sending. The `on_sending` and `on_sent`
+ * callbacks are called while rendering, not while playing the buffer.
+ *
+ * @param sdk             A pointer to the SDK structure.
+ * @param bytes           A pointer to the payload to render.
+ * @param length          The length, in bytes, of the payload.
+ * @param buffer          The buffer which will be filled with mono samples.
+ * @param buffer_length   The length, in mono samples, of the buffer. It must be
+ *                        at least the value returned by
+ *                        `chirp_sdk_get_render_length`.
+ * @param rendered_length A pointer updated with the number of samples written.
+ * @return                An error code resulting from the call. CHIRP_SDK_OK
+ *                        will be returned if everything went well, or
+ *                        CHIRP_SDK_BUFFER_TOO_SHORT if the buffer is too short,
+ *                        which is described by
+ *                        `chirp_sdk_module_error_code_to_string`.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_render_shorts(chirp_sdk_t *sdk, const uint8_t *bytes, size_t length, short *buffer, size_t buffer_length, size_t *rendered_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_AUDIO_H */
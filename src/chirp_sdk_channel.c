@@ -0,0 +1,259 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_channel.c
+ *
+ *  @brief Deterministic simulation of an acoustic channel, to measure the
+ *         decoding performance of the SDK without audio hardware.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include "chirp_sdk_channel.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*
+ * Xorshift generator, from "Xorshift RNGs" by George Marsaglia.
+ */
+static uint32_t next_random(chirp_sdk_channel_t *channel)
+{
+    uint32_t x = channel->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    channel->random_state = x;
+    return x;
+}
+
+/*
+ * Uniform draw in ]0, 1].
+ */
+static float next_uniform(chirp_sdk_channel_t *channel)
+{
+    return ((next_random(channel) >> 8) + 1) / 16777216.0f;
+}
+
+/*
+ * Gaussian draw of unit variance, with the Box-Muller transform.
+ */
+static float next_gaussian(chirp_sdk_channel_t *channel)
+{
+    float u1 = next_uniform(channel);
+    float u2 = next_uniform(channel);
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * (float) M_PI * u2);
+}
+
+static inline short saturate_short(float value)
+{
+    if (value > 32767.0f)
+        return 32767;
+    if (value < -32768.0f)
+        return -32768;
+    return (short) lrintf(value);
+}
+
+static size_t apply_drift(chirp_sdk_channel_t *channel, const short *input, size_t length, float *output, size_t output_capacity)
+{
+    /*
+     * Linear interpolation, where position -1 is the last sample of the
+     * previous block.
+     */
+    float step = 1.0f / channel->drift;
+    float position = channel->drift_position;
+    size_t count = 0;
+
+    while (position < (float) length - 1.0f)
+    {
+        int index = (int) floorf(position);
+        float frac = position - index;
+        float a = index < 0 ? channel->drift_last_sample : input[index];
+        float b = input[index + 1];
+        if (count < output_capacity)
+            output[count++] = a + (b - a) * frac;
+        position += step;
+    }
+
+    channel->drift_position = position - length;
+    if (length)
+        channel->drift_last_sample = input[length - 1];
+
+    return count;
+}
+
+static float apply_reverb(chirp_sdk_channel_t *channel, float sample)
+{
+    size_t length = channel->reverb_length;
+    channel->reverb_position = (channel->reverb_position ? channel->reverb_position : length) - 1;
+    channel->reverb_history[channel->reverb_position] = sample;
+
+    /*
+     * The ring buffer is read in two parts, from the newest sample.
+     */
+    const float *ir = channel->impulse_response;
+    size_t first = length - channel->reverb_position;
+    float y = 0;
+    for (size_t i = 0; i < first; i++)
+        y += ir[i] * channel->reverb_history[channel->reverb_position + i];
+    for (size_t i = first; i < length; i++)
+        y += ir[i] * channel->reverb_history[i - first];
+
+    return y;
+}
+
+chirp_sdk_error_code_t chirp_sdk_channel_init(chirp_sdk_channel_t *channel, uint32_t seed)
+{
+    if (!channel)
+        return CHIRP_SDK_NULL_POINTER;
+
+    memset(channel, 0, sizeof(*channel));
+    channel->random_state = seed ? seed : 0x9e3779b9;
+    channel->drift = 1.0f;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_channel_set_noise(chirp_sdk_channel_t *channel, float signal_rms, float snr)
+{
+    if (!channel)
+        return CHIRP_SDK_NULL_POINTER;
+
+    channel->noise_rms = signal_rms / powf(10.0f, snr / 20.0f);
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_channel_set_reverb(chirp_sdk_channel_t *channel, const float *impulse_response,
+                                                    float *history, size_t length)
+{
+    if (!channel)
+        return CHIRP_SDK_NULL_POINTER;
+    if (impulse_response && length && !history)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    if (!impulse_response)
+        length = 0;
+    if (length)
+        memset(history, 0, length * sizeof(*history));
+
+    channel->impulse_response = impulse_response;
+    channel->reverb_history = history;
+    channel->reverb_length = length;
+    channel->reverb_position = 0;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_channel_generate_reverb(chirp_sdk_channel_t *channel, float *impulse_response, size_t length,
+                                                         uint32_t sample_rate, float rt60)
+{
+    if (!channel)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!impulse_response)
+        return CHIRP_SDK_NULL_BUFFER;
+    if (sample_rate == 0)
+        return CHIRP_SDK_INVALID_SAMPLE_RATE;
+    if (length == 0)
+        return CHIRP_SDK_OK;
+
+    /*
+     * 60dB is a factor of 1000 in amplitude, ie. exp(-6.9).
+     */
+    float decay = rt60 > 0 ? 6.9078f / (rt60 * sample_rate) : INFINITY;
+    float energy = 1.0f;
+
+    impulse_response[0] = 1.0f;
+    for (size_t i = 1; i < length; i++)
+    {
+        impulse_response[i] = next_gaussian(channel) * expf(-decay * i);
+        energy += impulse_response[i] * impulse_response[i];
+    }
+
+    float scale = 1.0f / sqrtf(energy);
+    for (size_t i = 0; i < length; i++)
+        impulse_response[i] *= scale;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_channel_set_drift(chirp_sdk_channel_t *channel, float drift)
+{
+    if (!channel)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (drift < 0.5f)
+        drift = 0.5f;
+    if (drift > 1.5f)
+        drift = 1.5f;
+    channel->drift = drift;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_channel_set_drop_probability(chirp_sdk_channel_t *channel, float probability)
+{
+    if (!channel)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (probability < 0)
+        probability = 0;
+    if (probability > 1.0f)
+        probability = 1.0f;
+    channel->drop_probability = probability;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_channel_process_shorts(chirp_sdk_channel_t *channel, const short *input, size_t length,
+                                                        short *output, size_t output_capacity, size_t *output_length)
+{
+    if (!channel || !output_length)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!input || !output)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    /*
+     * The drift is resampled in small chunks of floats, so that the rest of
+     * the effects can be applied before the samples are saturated.
+     */
+    float chunk[64];
+    size_t count = 0;
+    size_t chunk_input = (size_t) (sizeof(chunk) / sizeof(chunk[0]) / channel->drift) - 2;
+
+    for (size_t offset = 0; offset < length; offset += chunk_input)
+    {
+        size_t n = length - offset < chunk_input ? length - offset : chunk_input;
+        size_t generated = apply_drift(channel, input + offset, n, chunk, sizeof(chunk) / sizeof(chunk[0]));
+
+        for (size_t i = 0; i < generated && count < output_capacity; i++)
+        {
+            float sample = chunk[i];
+            if (channel->reverb_length)
+                sample = apply_reverb(channel, sample);
+            if (channel->noise_rms > 0)
+                sample += channel->noise_rms * next_gaussian(channel);
+            output[count++] = saturate_short(sample);
+        }
+    }
+
+    *output_length = count;
+
+    if (channel->drop_probability > 0 && next_uniform(channel) <= channel->drop_probability)
+    {
+        channel->dropped_blocks++;
+        *output_length = 0;
+    }
+
+    return CHIRP_SDK_OK;
+}
@@ -0,0 +1,149 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_channel.h
+ *
+ *  @brief Deterministic simulation of an acoustic channel, to measure the
+ *         decoding performance of the SDK without audio hardware.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_CHANNEL_H
+#define CHIRP_SDK_CHANNEL_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Structure of a simulated channel. It is owned by the application and must
+ * be initialised with `chirp_sdk_channel_init`. All the random draws come
+ * from the seed, so a simulation can be repeated exactly.
+ */
+typedef struct {
+    uint32_t random_state; ///< State of the pseudo-random generator.
+    float noise_rms; ///< RMS amplitude of the additive white Gaussian noise.
+    const float *impulse_response; ///< Impulse response the audio is convolved with, or NULL.
+    float *reverb_history; ///< Ring buffer of the most recent samples, for the convolution.
+    size_t reverb_length; ///< The length, in samples, of the impulse response.
+    size_t reverb_position; ///< Index of the newest sample in the ring buffer.
+    float drift; ///< Ratio between the receiver and transmitter sample rates.
+    float drift_position; ///< Position of the next output sample, relative to the last input sample.
+    float drift_last_sample; ///< Last input sample of the previous block.
+    float drop_probability; ///< Probability for each block to be dropped.
+    uint32_t dropped_blocks; ///< Number of blocks dropped.
+} chirp_sdk_channel_t;
+
+/**
+ * Initialise a channel which leaves the audio untouched, until some of its
+ * effects are set.
+ *
+ * @param channel A pointer to the channel to initialise.
+ * @param seed    The seed of the pseudo-random generator.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_channel_init(chirp_sdk_channel_t *channel, uint32_t seed);
+
+/**
+ * Set the level of the additive white Gaussian noise.
+ *
+ * @param channel    A pointer to the channel.
+ * @param signal_rms The RMS amplitude, in sample units, of the signal the
+ *                   noise is relative to.
+ * @param snr        The signal to noise ratio, in dB.
+ * @return           An error code resulting from the call. CHIRP_SDK_OK will
+ *                   be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_channel_set_noise(chirp_sdk_channel_t *channel, float signal_rms, float snr);
+
+/**
+ * Set the impulse response of the room the audio is convolved with.
+ *
+ * @param channel          A pointer to the channel.
+ * @param impulse_response The impulse response, or NULL to disable the
+ *                         reverb. It must stay valid while it is used.
+ * @param history          A buffer holding the most recent samples, of the
+ *                         same length as the impulse response.
+ * @param length           The length, in samples, of the impulse response.
+ * @return                 An error code resulting from the call. CHIRP_SDK_OK
+ *                         will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_channel_set_reverb(chirp_sdk_channel_t *channel, const float *impulse_response,
+                                                               float *history, size_t length);
+
+/**
+ * Fill an impulse response with a synthetic room response: a direct path
+ * followed by an exponentially decaying noise tail, with a unity energy.
+ * The noise is drawn from the pseudo-random generator of the channel.
+ *
+ * @param channel          A pointer to the channel.
+ * @param impulse_response The buffer to fill.
+ * @param length           The length, in samples, of the buffer.
+ * @param sample_rate      The sample rate of the audio.
+ * @param rt60             The time, in seconds, the tail takes to decay by
+ *                         60dB.
+ * @return                 An error code resulting from the call. CHIRP_SDK_OK
+ *                         will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_channel_generate_reverb(chirp_sdk_channel_t *channel, float *impulse_response, size_t length,
+                                                                    uint32_t sample_rate, float rt60);
+
+/**
+ * Set the clock drift between the transmitter and the receiver. The audio is
+ * resampled so that the receiver gets `drift` samples for each sample sent,
+ * which is the mismatch `chirp_sdk_set_frequency_correction` compensates for.
+ *
+ * @param channel A pointer to the channel.
+ * @param drift   The ratio between the receiver and transmitter sample
+ *                rates, between 0.5 and 1.5.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_channel_set_drift(chirp_sdk_channel_t *channel, float drift);
+
+/**
+ * Set the probability for each block to be dropped, as if the receiver
+ * missed an audio buffer.
+ *
+ * @param channel     A pointer to the channel.
+ * @param probability The probability, between 0 and 1.
+ * @return            An error code resulting from the call. CHIRP_SDK_OK
+ *                    will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_channel_set_drop_probability(chirp_sdk_channel_t *channel, float probability);
+
+/**
+ * Pass a block of audio through the channel. The drift is applied first,
+ * then the reverb and the noise, and finally the block may be dropped, in
+ * which case `output_length` is set to 0.
+ *
+ * @param channel         A pointer to the channel.
+ * @param input           The audio sent, as mono samples.
+ * @param length          The length, in samples, of the input.
+ * @param output          The buffer filled with the audio received.
+ * @param output_capacity The length, in samples, of the output buffer. It
+ *                        should hold `length * drift + 1` samples, any extra
+ *                        sample is lost.
+ * @param output_length   A pointer updated with the number of samples
+ *                        received.
+ * @return                An error code resulting from the call. CHIRP_SDK_OK
+ *                        will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_channel_process_shorts(chirp_sdk_channel_t *channel, const short *input, size_t length,
+                                                                   short *output, size_t output_capacity, size_t *output_length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_CHANNEL_H */
@@ -0,0 +1,305 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_duplex.c
+ *
+ *  @brief Full-duplex operation, cancelling the echo of the audio sent from
+ *         the audio received.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include "chirp_sdk_audio.h"
+#include "chirp_sdk_duplex.h"
+
+#define HISTORY_MASK (CHIRP_SDK_DUPLEX_HISTORY_SIZE - 1)
+
+/*
+ * Regularisation of the normalisation, as the power of a reference at
+ * -60dBFS under the whole filter. It also stops the adaptation when nothing
+ * is being sent.
+ */
+#define POWER_FLOOR (CHIRP_SDK_DUPLEX_TAPS * 1e-6f)
+
+/*
+ * Time constant, in samples, of the powers the ERLE is measured from.
+ */
+#define ERLE_SMOOTHING (1.0f / 1024.0f)
+
+static inline short saturate_short(float value)
+{
+    if (value > 32767.0f)
+        return 32767;
+    if (value < -32768.0f)
+        return -32768;
+    return (short) lrintf(value);
+}
+
+static inline float reference_at(chirp_sdk_duplex_t *duplex, uint32_t position)
+{
+    return duplex->reference[position & HISTORY_MASK] * (1.0f / 32768.0f);
+}
+
+static void update_reference_power(chirp_sdk_duplex_t *duplex, uint32_t newest)
+{
+    if (newest == duplex->power_position + 1)
+    {
+        float in = reference_at(duplex, newest);
+        float out = reference_at(duplex, newest - CHIRP_SDK_DUPLEX_TAPS);
+        duplex->reference_power += in * in - out * out;
+        if (duplex->reference_power < 0)
+            duplex->reference_power = 0;
+    }
+    else
+    {
+        float power = 0;
+        for (uint32_t k = 0; k < CHIRP_SDK_DUPLEX_TAPS; k++)
+        {
+            float x = reference_at(duplex, newest - k);
+            power += x * x;
+        }
+        duplex->reference_power = power;
+    }
+    duplex->power_position = newest;
+}
+
+/*
+ * Move the bulk delay so that the peak of the echo path sits an eighth of
+ * the way into the filter, leaving room for a path getting shorter. While
+ * the filter has no clear peak, the echo is searched for at shorter delays,
+ * half a filter at a time, wrapping around to the longest delay.
+ */
+static void track_delay(chirp_sdk_duplex_t *duplex)
+{
+    uint32_t peak = 0;
+    float peak_value = 0;
+    float sum = 0;
+
+    for (uint32_t k = 0; k < CHIRP_SDK_DUPLEX_TAPS; k++)
+    {
+        float value = fabsf(duplex->weights[k]);
+        sum += value;
+        if (value > peak_value)
+        {
+            peak_value = value;
+            peak = k;
+        }
+    }
+
+    if (peak_value < 8.0f * sum / CHIRP_SDK_DUPLEX_TAPS)
+    {
+        if (duplex->delay == 0)
+            duplex->delay = CHIRP_SDK_DUPLEX_MAX_DELAY;
+        else if (duplex->delay < CHIRP_SDK_DUPLEX_TAPS / 2)
+            duplex->delay = 0;
+        else
+            duplex->delay -= CHIRP_SDK_DUPLEX_TAPS / 2;
+        memset(duplex->weights, 0, sizeof(duplex->weights));
+        return;
+    }
+
+    int32_t shift = (int32_t) peak - CHIRP_SDK_DUPLEX_TAPS / 8;
+    if (shift < CHIRP_SDK_DUPLEX_TAPS / 16 && shift > -CHIRP_SDK_DUPLEX_TAPS / 16)
+        return;
+
+    int32_t delay = (int32_t) duplex->delay + shift;
+    if (delay < 0)
+        delay = 0;
+    if (delay > CHIRP_SDK_DUPLEX_MAX_DELAY)
+        delay = CHIRP_SDK_DUPLEX_MAX_DELAY;
+    shift = delay - (int32_t) duplex->delay;
+    if (shift == 0)
+        return;
+
+    if (shift > 0)
+    {
+        memmove(duplex->weights, duplex->weights + shift, (CHIRP_SDK_DUPLEX_TAPS - shift) * sizeof(float));
+        memset(duplex->weights + CHIRP_SDK_DUPLEX_TAPS - shift, 0, shift * sizeof(float));
+    }
+    else
+    {
+        memmove(duplex->weights - shift, duplex->weights, (CHIRP_SDK_DUPLEX_TAPS + shift) * sizeof(float));
+        memset(duplex->weights, 0, -shift * sizeof(float));
+    }
+    duplex->delay = delay;
+}
+
+chirp_sdk_error_code_t chirp_sdk_duplex_init(chirp_sdk_duplex_t *duplex, chirp_sdk_t *sdk, uint32_t delay)
+{
+    if (!duplex)
+        return CHIRP_SDK_NULL_POINTER;
+
+    memset(duplex, 0, sizeof(*duplex));
+    duplex->sdk = sdk;
+    duplex->step = 0.1f;
+    duplex->delay = delay > CHIRP_SDK_DUPLEX_MAX_DELAY ? CHIRP_SDK_DUPLEX_MAX_DELAY : delay;
+    duplex->delay_tracking = true;
+    duplex->double_talk_threshold = 1.0f;
+    duplex->power_position = UINT32_MAX / 2;
+
+    return chirp_sdk_set_listen_to_self(sdk, true);
+}
+
+chirp_sdk_error_code_t chirp_sdk_duplex_set_step(chirp_sdk_duplex_t *duplex, float step)
+{
+    if (!duplex)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (step < 0)
+        step = 0;
+    if (step > 1.0f)
+        step = 1.0f;
+    duplex->step = step;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_duplex_set_double_talk_threshold(chirp_sdk_duplex_t *duplex, float threshold)
+{
+    if (!duplex)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (threshold < 0)
+        threshold = 0;
+    duplex->double_talk_threshold = threshold;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_duplex_set_delay_tracking(chirp_sdk_duplex_t *duplex, bool enabled)
+{
+    if (!duplex)
+        return CHIRP_SDK_NULL_POINTER;
+
+    duplex->delay_tracking = enabled;
+
+    return CHIRP_SDK_OK;
+}
+
+uint32_t chirp_sdk_duplex_get_delay(chirp_sdk_duplex_t *duplex)
+{
+    if (!duplex)
+        return 0;
+
+    return duplex->delay;
+}
+
+float chirp_sdk_duplex_get_erle(chirp_sdk_duplex_t *duplex)
+{
+    if (!duplex || duplex->input_power <= 0 || duplex->residual_power <= 0)
+        return 0;
+
+    return 10.0f * log10f(duplex->input_power / duplex->residual_power);
+}
+
+chirp_sdk_error_code_t chirp_sdk_duplex_process_shorts_output(chirp_sdk_duplex_t *duplex, short *buffer, size_t length)
+{
+    if (!duplex)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    chirp_sdk_error_code_t err = chirp_sdk_process_shorts_output(duplex->sdk, buffer, length);
+    if (err != CHIRP_SDK_OK)
+        return err;
+
+    uint32_t position = duplex->output_position;
+    for (size_t i = 0; i < length; i++)
+        duplex->reference[(position + i) & HISTORY_MASK] = buffer[i];
+    __atomic_store_n(&duplex->output_position, position + length, __ATOMIC_RELEASE);
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_duplex_process_shorts_input(chirp_sdk_duplex_t *duplex, const short *buffer, size_t length)
+{
+    if (!duplex)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    short chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+    float *weights = duplex->weights;
+
+    while (length > 0)
+    {
+        size_t count = length < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+        uint32_t output_position = __atomic_load_n(&duplex->output_position, __ATOMIC_ACQUIRE);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            float d = buffer[i] * (1.0f / 32768.0f);
+            uint32_t newest = duplex->input_position - duplex->delay;
+            int32_t age = (int32_t) (output_position - newest);
+            duplex->input_position++;
+
+            /*
+             * The echo can only be cancelled once the output it comes from
+             * has been processed, and while it is still in the history. A
+             * delay reaching out of the history is left for the tracking to
+             * bring back.
+             */
+            if (age < 1 || age > CHIRP_SDK_DUPLEX_HISTORY_SIZE - CHIRP_SDK_DUPLEX_TAPS + 1)
+            {
+                if (age > 0)
+                    duplex->tracking_samples++;
+                chunk[i] = buffer[i];
+                continue;
+            }
+
+            update_reference_power(duplex, newest);
+
+            float y = 0;
+            float peak = 0;
+            for (uint32_t k = 0; k < CHIRP_SDK_DUPLEX_TAPS; k++)
+            {
+                float x = reference_at(duplex, newest - k);
+                y += weights[k] * x;
+                peak = fmaxf(peak, fabsf(x));
+            }
+
+            if (duplex->double_talk_threshold > 0 && fabsf(d) > duplex->double_talk_threshold * peak)
+                duplex->double_talk_hangover = CHIRP_SDK_DUPLEX_DOUBLE_TALK_HANGOVER;
+            else if (duplex->double_talk_hangover > 0)
+                duplex->double_talk_hangover--;
+
+            float e = d - y;
+            if (duplex->reference_power > POWER_FLOOR && duplex->double_talk_hangover == 0)
+            {
+                float gain = duplex->step * e / (duplex->reference_power + POWER_FLOOR);
+                for (uint32_t k = 0; k < CHIRP_SDK_DUPLEX_TAPS; k++)
+                    weights[k] += gain * reference_at(duplex, newest - k);
+
+                duplex->input_power += (d * d - duplex->input_power) * ERLE_SMOOTHING;
+                duplex->residual_power += (e * e - duplex->residual_power) * ERLE_SMOOTHING;
+                duplex->tracking_samples++;
+            }
+
+            chunk[i] = saturate_short(e * 32768.0f);
+        }
+
+        if (duplex->delay_tracking && duplex->tracking_samples >= CHIRP_SDK_DUPLEX_TRACKING_INTERVAL)
+        {
+            track_delay(duplex);
+            duplex->tracking_samples = 0;
+        }
+
+        chirp_sdk_error_code_t err = chirp_sdk_process_shorts_input(duplex->sdk, chunk, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        buffer += count;
+        length -= count;
+    }
+
+    return CHIRP_SDK_OK;
+}
@@ -0,0 +1,217 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_duplex.h
+ *
+ *  @brief Full-duplex operation, cancelling the echo of the audio sent from
+ *         the audio received.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_DUPLEX_H
+#define CHIRP_SDK_DUPLEX_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of taps of the adaptive filter modelling the echo path. It covers
+ * the impulse response of the speaker, the room and the microphone after
+ * the bulk delay. The cost of the canceller is twice this many
+ * multiply-adds per input sample.
+ */
+#ifndef CHIRP_SDK_DUPLEX_TAPS
+#define CHIRP_SDK_DUPLEX_TAPS 128
+#endif
+
+/**
+ * Number of output samples kept as the reference of the echo. It bounds the
+ * bulk delay to `CHIRP_SDK_DUPLEX_HISTORY_SIZE - CHIRP_SDK_DUPLEX_TAPS`
+ * samples. This must be a power of two.
+ */
+#ifndef CHIRP_SDK_DUPLEX_HISTORY_SIZE
+#define CHIRP_SDK_DUPLEX_HISTORY_SIZE 2048
+#endif
+
+#if (CHIRP_SDK_DUPLEX_HISTORY_SIZE & (CHIRP_SDK_DUPLEX_HISTORY_SIZE - 1)) != 0
+#error "CHIRP_SDK_DUPLEX_HISTORY_SIZE must be a power of two"
+#endif
+
+#if CHIRP_SDK_DUPLEX_HISTORY_SIZE <= CHIRP_SDK_DUPLEX_TAPS
+#error "CHIRP_SDK_DUPLEX_HISTORY_SIZE must be larger than CHIRP_SDK_DUPLEX_TAPS"
+#endif
+
+#define CHIRP_SDK_DUPLEX_MAX_DELAY (CHIRP_SDK_DUPLEX_HISTORY_SIZE - CHIRP_SDK_DUPLEX_TAPS)
+
+/**
+ * Number of input samples between two updates of the bulk delay, when it is
+ * tracked.
+ */
+#ifndef CHIRP_SDK_DUPLEX_TRACKING_INTERVAL
+#define CHIRP_SDK_DUPLEX_TRACKING_INTERVAL 4096
+#endif
+
+/**
+ * Number of input samples the adaptation stays frozen for once double talk
+ * has been detected, about 30ms at 16kHz. It bridges the quieter parts of
+ * the near-end signal, which the detector would otherwise miss.
+ */
+#ifndef CHIRP_SDK_DUPLEX_DOUBLE_TALK_HANGOVER
+#define CHIRP_SDK_DUPLEX_DOUBLE_TALK_HANGOVER 512
+#endif
+
+/**
+ * Structure of the echo canceller. The audio sent by the SDK is kept as a
+ * reference, and a normalised least mean squares filter learns the echo
+ * path from it, so that the echo can be subtracted from the audio received
+ * before it is decoded. The filter is frozen while another device is heard
+ * over the echo, so that it does not learn the other device's chirp as part
+ * of the echo path. It is owned by the application and must be initialised
+ * with `chirp_sdk_duplex_init`.
+ */
+typedef struct {
+    chirp_sdk_t *sdk; ///< The SDK the audio is processed with.
+    float step; ///< Adaptation step of the filter, between 0 and 1.
+    uint32_t delay; ///< Bulk delay, in samples, between the output and its echo in the input.
+    bool delay_tracking; ///< Set to follow the delay from the peak of the filter.
+    float double_talk_threshold; ///< Level of the input, relative to the reference, taken as double talk.
+    uint32_t double_talk_hangover; ///< Number of input samples left before the adaptation resumes.
+    uint32_t output_position; ///< Number of output samples processed.
+    uint32_t input_position; ///< Number of input samples processed.
+    uint32_t tracking_samples; ///< Number of input samples since the delay was last updated.
+    uint32_t power_position; ///< Position of the newest reference sample in `reference_power`.
+    float reference_power; ///< Power of the reference under the filter.
+    float input_power; ///< Smoothed power of the input.
+    float residual_power; ///< Smoothed power of the input once the echo is cancelled.
+    float weights[CHIRP_SDK_DUPLEX_TAPS]; ///< Coefficients of the filter.
+    short reference[CHIRP_SDK_DUPLEX_HISTORY_SIZE]; ///< Ring buffer of the most recent output samples.
+} chirp_sdk_duplex_t;
+
+/**
+ * Initialise an echo canceller, and set the SDK to listen to itself so that
+ * the decoder is not muted while sending.
+ *
+ * The input and output must be processed from the same audio clock, and
+ * `delay` is the number of samples between an output sample being
+ * processed and its echo being processed as input. This is mostly the
+ * buffering of the audio driver in both directions, for example
+ * `2 * BUFFER_SIZE` for a driver double-buffering each direction. It is
+ * refined by the delay tracking.
+ *
+ * The echo left after cancellation can still be decoded, mostly while the
+ * filter converges, so the payloads sent by the device itself can also be
+ * received. The canceller does not filter them out: compare the payloads
+ * received to the ones reported by `on_sent` to ignore them.
+ *
+ * @param duplex A pointer to the echo canceller to initialise.
+ * @param sdk    A pointer to the SDK structure.
+ * @param delay  The bulk delay, in samples, between 0 and
+ *               CHIRP_SDK_DUPLEX_MAX_DELAY. Values out of range are clamped.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_duplex_init(chirp_sdk_duplex_t *duplex, chirp_sdk_t *sdk, uint32_t delay);
+
+/**
+ * Set the adaptation step of the filter. Larger steps converge faster, but
+ * leave more residual echo and are disturbed more by the chirps of other
+ * devices. Defaults to 0.1.
+ *
+ * @param duplex A pointer to the echo canceller.
+ * @param step   The step, between 0 and 1. Values out of range are clamped.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_duplex_set_step(chirp_sdk_duplex_t *duplex, float step);
+
+/**
+ * Set the threshold of the double talk detector. The input is taken as
+ * double talk, and the adaptation is frozen, when a sample is louder than
+ * `threshold` times the loudest reference sample under the filter, as in
+ * the Geigel detector. It must be above the gain of the echo path, from the
+ * samples sent to their echo in the samples received, or the echo itself is
+ * taken as double talk and the filter never converges. Defaults to 1, for
+ * an echo no louder than the audio sent.
+ *
+ * @param duplex    A pointer to the echo canceller.
+ * @param threshold The threshold, as a ratio of levels, or 0 to disable
+ *                  the detection. Values below 0 are clamped.
+ * @return          An error code resulting from the call. CHIRP_SDK_OK will
+ *                  be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_duplex_set_double_talk_threshold(chirp_sdk_duplex_t *duplex, float threshold);
+
+/**
+ * Enable or disable the tracking of the bulk delay. When enabled, the delay
+ * is moved so that the main peak of the echo path stays near the start of
+ * the filter, and the echo is searched for over the whole history when the
+ * filter does not find it, for example when the delay given to
+ * `chirp_sdk_duplex_init` is too long. Enabled by default.
+ *
+ * @param duplex  A pointer to the echo canceller.
+ * @param enabled True to track the delay.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_duplex_set_delay_tracking(chirp_sdk_duplex_t *duplex, bool enabled);
+
+/**
+ * Get the bulk delay currently used.
+ *
+ * @param duplex A pointer to the echo canceller.
+ * @return       The delay, in samples.
+ */
+PUBLIC_SYM uint32_t chirp_sdk_duplex_get_delay(chirp_sdk_duplex_t *duplex);
+
+/**
+ * Get the echo return loss enhancement, ie. how much the canceller lowers
+ * the level of the input while sending. It is only meaningful while the
+ * echo dominates the input.
+ *
+ * @param duplex A pointer to the echo canceller.
+ * @return       The enhancement, in dB.
+ */
+PUBLIC_SYM float chirp_sdk_duplex_get_erle(chirp_sdk_duplex_t *duplex);
+
+/**
+ * Short audio processing function for the encoding (output), keeping the
+ * audio sent as the reference of the echo. This replaces
+ * `chirp_sdk_process_shorts_output`.
+ *
+ * @param duplex A pointer to the echo canceller.
+ * @param buffer The output buffer which will be filled with new mono samples.
+ * @param length The length, in mono samples, of the output buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_duplex_process_shorts_output(chirp_sdk_duplex_t *duplex, short *buffer, size_t length);
+
+/**
+ * Short audio processing function for the decoding (input), cancelling the
+ * echo of the audio sent before it is decoded. This replaces
+ * `chirp_sdk_process_shorts_input`.
+ *
+ * @param duplex A pointer to the echo canceller.
+ * @param buffer The input buffer containing mono samples which will be
+ *               decoded. It is not modified.
+ * @param length The length, in mono samples, of the input buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_duplex_process_shorts_input(chirp_sdk_duplex_t *duplex, const short *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_DUPLEX_H */
@@ -0,0 +1,189 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_event_queue.c
+ *
+ *  @brief Deferred dispatch of the SDK callbacks, allowing the audio to be
+ *         processed from a different context than the application.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "chirp_sdk_event_queue.h"
+
+/*
+ * Reserve the next free slot of the queue, or return NULL if it is full. The
+ * event is only made visible to the consumer by `commit_event`.
+ */
+static chirp_sdk_event_t *reserve_event(chirp_sdk_event_queue_t *queue)
+{
+    uint32_t head = queue->head;
+    uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= CHIRP_SDK_EVENT_QUEUE_SIZE)
+    {
+        queue->dropped++;
+        return NULL;
+    }
+    return &queue->events[head & (CHIRP_SDK_EVENT_QUEUE_SIZE - 1)];
+}
+
+static void commit_event(chirp_sdk_event_queue_t *queue)
+{
+    __atomic_store_n(&queue->head, queue->head + 1, __ATOMIC_RELEASE);
+}
+
+static void push_payload_event(void *ptr, chirp_sdk_event_type_t type, uint8_t *bytes, size_t length, uint8_t channel)
+{
+    chirp_sdk_event_queue_t *queue = (chirp_sdk_event_queue_t *) ptr;
+    chirp_sdk_event_t *event = reserve_event(queue);
+    if (!event)
+        return;
+
+    if (length > CHIRP_SDK_EVENT_MAX_PAYLOAD_LENGTH)
+        length = CHIRP_SDK_EVENT_MAX_PAYLOAD_LENGTH;
+
+    event->type = type;
+    event->has_payload = bytes != NULL;
+    event->channel = channel;
+    event->length = bytes ? length : 0;
+    if (bytes)
+        memcpy(event->bytes, bytes, event->length);
+
+    commit_event(queue);
+}
+
+static void on_state_changed(void *ptr, chirp_sdk_state_t old_state, chirp_sdk_state_t new_state)
+{
+    chirp_sdk_event_queue_t *queue = (chirp_sdk_event_queue_t *) ptr;
+    chirp_sdk_event_t *event = reserve_event(queue);
+    if (!event)
+        return;
+
+    event->type = CHIRP_SDK_EVENT_STATE_CHANGED;
+    event->old_state = old_state;
+    event->new_state = new_state;
+
+    commit_event(queue);
+}
+
+static void on_sending(void *ptr, uint8_t *bytes, size_t length, uint8_t channel)
+{
+    push_payload_event(ptr, CHIRP_SDK_EVENT_SENDING, bytes, length, channel);
+}
+
+static void on_sent(void *ptr, uint8_t *bytes, size_t length, uint8_t channel)
+{
+    push_payload_event(ptr, CHIRP_SDK_EVENT_SENT, bytes, length, channel);
+}
+
+static void on_receiving(void *ptr, uint8_t *bytes, size_t length, uint8_t channel)
+{
+    push_payload_event(ptr, CHIRP_SDK_EVENT_RECEIVING, bytes, length, channel);
+}
+
+static void on_received(void *ptr, uint8_t *bytes, size_t length, uint8_t channel)
+{
+    push_payload_event(ptr, CHIRP_SDK_EVENT_RECEIVED, bytes, length, channel);
+}
+
+chirp_sdk_error_code_t chirp_sdk_set_deferred_callbacks(chirp_sdk_t *sdk, chirp_sdk_event_queue_t *queue, chirp_sdk_callback_set_t callback_set, void *ptr)
+{
+    if (!queue)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (chirp_sdk_get_max_payload_length(sdk) > CHIRP_SDK_EVENT_MAX_PAYLOAD_LENGTH)
+        return CHIRP_SDK_PAYLOAD_TOO_LONG;
+
+    queue->callbacks = callback_set;
+    queue->ptr = ptr;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+
+    /*
+     * Only register the callbacks which are set, so that no event is queued
+     * for nothing.
+     */
+    chirp_sdk_callback_set_t deferred = {0};
+    if (callback_set.on_state_changed)
+        deferred.on_state_changed = on_state_changed;
+    if (callback_set.on_sending)
+        deferred.on_sending = on_sending;
+    if (callback_set.on_sent)
+        deferred.on_sent = on_sent;
+    if (callback_set.on_receiving)
+        deferred.on_receiving = on_receiving;
+    if (callback_set.on_received)
+        deferred.on_received = on_received;
+
+    chirp_sdk_error_code_t err = chirp_sdk_set_callback_ptr(sdk, queue);
+    if (err != CHIRP_SDK_OK)
+        return err;
+
+    return chirp_sdk_set_callbacks(sdk, deferred);
+}
+
+size_t chirp_sdk_dispatch_callbacks(chirp_sdk_event_queue_t *queue)
+{
+    if (!queue)
+        return 0;
+
+    size_t count = 0;
+    uint32_t tail = queue->tail;
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+
+    while (tail != head)
+    {
+        chirp_sdk_event_t *event = &queue->events[tail & (CHIRP_SDK_EVENT_QUEUE_SIZE - 1)];
+        chirp_sdk_callback_set_t *callbacks = &queue->callbacks;
+        uint8_t *bytes = event->has_payload ? event->bytes : NULL;
+
+        switch (event->type)
+        {
+            case CHIRP_SDK_EVENT_STATE_CHANGED:
+                callbacks->on_state_changed(queue->ptr, event->old_state, event->new_state);
+                break;
+            case CHIRP_SDK_EVENT_SENDING:
+                callbacks->on_sending(queue->ptr, bytes, event->length, event->channel);
+                break;
+            case CHIRP_SDK_EVENT_SENT:
+                callbacks->on_sent(queue->ptr, bytes, event->length, event->channel);
+                break;
+            case CHIRP_SDK_EVENT_RECEIVING:
+                callbacks->on_receiving(queue->ptr, bytes, event->length, event->channel);
+                break;
+            case CHIRP_SDK_EVENT_RECEIVED:
+                callbacks->on_received(queue->ptr, bytes, event->length, event->channel);
+                break;
+        }
+
+        /*
+         * The slot is only released once the callback has returned, as the
+         * payload given to it points into the queue.
+         */
+        tail++;
+        __atomic_store_n(&queue->tail, tail, __ATOMIC_RELEASE);
+        count++;
+
+        if (tail == head)
+            head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    }
+
+    return count;
+}
+
+uint32_t chirp_sdk_get_dropped_event_count(chirp_sdk_event_queue_t *queue)
+{
+    if (!queue)
+        return 0;
+
+    return queue->dropped;
+}
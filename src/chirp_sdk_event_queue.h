@@ -0,0 +1,144 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_event_queue.h
+ *
+ *  @brief Deferred dispatch of the SDK callbacks, allowing the audio to be
+ *         processed from a different context than the application.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_EVENT_QUEUE_H
+#define CHIRP_SDK_EVENT_QUEUE_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of events the queue can hold before new events are dropped. This
+ * must be a power of two.
+ */
+#ifndef CHIRP_SDK_EVENT_QUEUE_SIZE
+#define CHIRP_SDK_EVENT_QUEUE_SIZE 8
+#endif
+
+#if (CHIRP_SDK_EVENT_QUEUE_SIZE & (CHIRP_SDK_EVENT_QUEUE_SIZE - 1)) != 0
+#error "CHIRP_SDK_EVENT_QUEUE_SIZE must be a power of two"
+#endif
+
+/**
+ * Maximum payload length, in bytes, carried by a queued event. This must be
+ * at least the value returned by `chirp_sdk_get_max_payload_length`.
+ */
+#ifndef CHIRP_SDK_EVENT_MAX_PAYLOAD_LENGTH
+#define CHIRP_SDK_EVENT_MAX_PAYLOAD_LENGTH 32
+#endif
+
+/**
+ * Type of the events stored in the queue, one for each callback of the
+ * `chirp_sdk_callback_set_t` structure.
+ */
+typedef enum {
+    CHIRP_SDK_EVENT_STATE_CHANGED, ///< Dispatched to on_state_changed.
+    CHIRP_SDK_EVENT_SENDING, ///< Dispatched to on_sending.
+    CHIRP_SDK_EVENT_SENT, ///< Dispatched to on_sent.
+    CHIRP_SDK_EVENT_RECEIVING, ///< Dispatched to on_receiving.
+    CHIRP_SDK_EVENT_RECEIVED, ///< Dispatched to on_received.
+} chirp_sdk_event_type_t;
+
+/**
+ * A callback event, with a copy of its arguments.
+ */
+typedef struct {
+    chirp_sdk_event_type_t type; ///< The callback this event will be dispatched to.
+    chirp_sdk_state_t old_state; ///< The old state, for CHIRP_SDK_EVENT_STATE_CHANGED.
+    chirp_sdk_state_t new_state; ///< The new state, for CHIRP_SDK_EVENT_STATE_CHANGED.
+    bool has_payload; ///< False if the callback was given a NULL payload.
+    uint8_t channel; ///< Channel on which the data has been sent or received.
+    size_t length; ///< The length, in bytes, of the payload.
+    uint8_t bytes[CHIRP_SDK_EVENT_MAX_PAYLOAD_LENGTH]; ///< A copy of the payload.
+} chirp_sdk_event_t;
+
+/**
+ * Single-producer single-consumer queue of callback events. The producer is
+ * the context calling the `chirp_sdk_process*` functions, for example a high
+ * priority audio task, and the consumer is the context calling
+ * `chirp_sdk_dispatch_callbacks`. The structure is owned by the application
+ * and must live as long as the SDK.
+ */
+typedef struct {
+    chirp_sdk_callback_set_t callbacks; ///< The callbacks events are dispatched to.
+    void *ptr; ///< The pointer passed to the callbacks.
+    volatile uint32_t head; ///< Index of the next event written, only updated by the producer.
+    volatile uint32_t tail; ///< Index of the next event read, only updated by the consumer.
+    volatile uint32_t dropped; ///< Number of events dropped because the queue was full.
+    chirp_sdk_event_t events[CHIRP_SDK_EVENT_QUEUE_SIZE]; ///< The events storage.
+} chirp_sdk_event_queue_t;
+
+/**
+ * Set the callbacks to the SDK, deferring them. Instead of being called from
+ * within the `chirp_sdk_process*` functions, the events are copied into the
+ * queue, in a bounded time and without any allocation, and the callbacks are
+ * only called by `chirp_sdk_dispatch_callbacks`.
+ *
+ * This keeps the work of the callbacks, such as printing or networking, out
+ * of the context processing the audio, for example a high priority audio
+ * task, as long as `chirp_sdk_dispatch_callbacks` is called regularly from
+ * the main loop or another task.
+ *
+ * The processing functions must still not be called from an interrupt: the
+ * decoder allocates memory, and the error correction at the end of a chirp
+ * takes much longer than the buffer it is given. Use `chirp_sdk_pipeline_t`
+ * to move the audio out of the interrupt.
+ *
+ * The config must have been set before calling this function. This replaces
+ * any callbacks and callback pointer previously set, and neither
+ * `chirp_sdk_set_callbacks` nor `chirp_sdk_set_callback_ptr` should be called
+ * afterwards.
+ *
+ * @param sdk          A pointer to the SDK structure.
+ * @param queue        A pointer to the queue the events will be stored in.
+ * @param callback_set A set of callbacks which will be called on dispatch.
+ * @param ptr          A pointer to any data you want to pass to the callbacks.
+ * @return             An error code resulting from the call. CHIRP_SDK_OK will
+ *                     be returned if everything went well, or
+ *                     CHIRP_SDK_PAYLOAD_TOO_LONG if the config allows payloads
+ *                     longer than CHIRP_SDK_EVENT_MAX_PAYLOAD_LENGTH.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_set_deferred_callbacks(chirp_sdk_t *sdk, chirp_sdk_event_queue_t *queue, chirp_sdk_callback_set_t callback_set, void *ptr);
+
+/**
+ * Call the callbacks of all the events stored in the queue, in the order they
+ * happened. This must always be called from the same context, which must not
+ * be an interrupt.
+ *
+ * @param queue A pointer to the queue given to `chirp_sdk_set_deferred_callbacks`.
+ * @return      The number of events dispatched.
+ */
+PUBLIC_SYM size_t chirp_sdk_dispatch_callbacks(chirp_sdk_event_queue_t *queue);
+
+/**
+ * Get the number of events dropped because the queue was full when they
+ * happened. If this is not 0, `chirp_sdk_dispatch_callbacks` should be called
+ * more often or CHIRP_SDK_EVENT_QUEUE_SIZE increased.
+ *
+ * @param queue A pointer to the queue given to `chirp_sdk_set_deferred_callbacks`.
+ * @return      The number of events dropped since the queue was set.
+ */
+PUBLIC_SYM uint32_t chirp_sdk_get_dropped_event_count(chirp_sdk_event_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_EVENT_QUEUE_H */
@@ -0,0 +1,262 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_gate.c
+ *
+ *  @brief Low-cost band energy gate skipping the decoding of silence.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include "chirp_sdk_gate.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*
+ * Lowest noise floor, in squared sample units, so that digital silence does
+ * not make the gate open on the smallest noise.
+ */
+#define MIN_NOISE_FLOOR 1.0f
+
+/*
+ * Rate, per block, at which the noise floor follows a rising band energy
+ * while the gate is closed. It follows a falling one immediately.
+ */
+#define NOISE_FLOOR_RATE 0.05f
+
+/*
+ * Rate, per block, at which the noise floor follows a rising band energy
+ * while the gate is open and the SDK is not receiving. It is slow enough for
+ * the SDK to start receiving a chirp first, and lets the gate close again
+ * if the ambient noise has risen for good.
+ */
+#define NOISE_FLOOR_OPEN_RATE 0.002f
+
+typedef enum {
+    FILTER_HIGH_PASS,
+    FILTER_LOW_PASS,
+} filter_type_t;
+
+/*
+ * Butterworth sections, from the Audio EQ Cookbook by Robert Bristow-Johnson.
+ */
+static void init_biquad(chirp_sdk_biquad_t *biquad, filter_type_t type, float frequency, float sample_rate)
+{
+    memset(biquad, 0, sizeof(*biquad));
+
+    if (frequency <= 0 || frequency >= sample_rate / 2)
+    {
+        biquad->b0 = 1.0f;
+        return;
+    }
+
+    float w0 = 2.0f * (float) M_PI * frequency / sample_rate;
+    float cos_w0 = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * 0.70710678f);
+    float a0 = 1.0f + alpha;
+
+    if (type == FILTER_HIGH_PASS)
+    {
+        biquad->b0 = (1.0f + cos_w0) / 2.0f / a0;
+        biquad->b1 = -(1.0f + cos_w0) / a0;
+    }
+    else
+    {
+        biquad->b0 = (1.0f - cos_w0) / 2.0f / a0;
+        biquad->b1 = (1.0f - cos_w0) / a0;
+    }
+    biquad->b2 = biquad->b0;
+    biquad->a1 = -2.0f * cos_w0 / a0;
+    biquad->a2 = (1.0f - alpha) / a0;
+}
+
+static inline float run_biquad(chirp_sdk_biquad_t *biquad, float x)
+{
+    float y = biquad->b0 * x + biquad->z1;
+    biquad->z1 = biquad->b1 * x - biquad->a1 * y + biquad->z2;
+    biquad->z2 = biquad->b2 * x - biquad->a2 * y;
+    return y;
+}
+
+static float band_energy(chirp_sdk_gate_t *gate, const short *buffer, size_t length)
+{
+    float energy = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        float y = run_biquad(&gate->low_pass, run_biquad(&gate->high_pass, buffer[i]));
+        energy += y * y;
+    }
+    return length ? energy / length : 0;
+}
+
+/*
+ * Follow a falling band energy immediately, and a rising one at `rate`.
+ */
+static void update_noise_floor(chirp_sdk_gate_t *gate, float energy, float rate)
+{
+    if (energy < gate->noise_floor || gate->noise_floor == 0)
+        gate->noise_floor = energy;
+    else
+        gate->noise_floor += (energy - gate->noise_floor) * rate;
+    if (gate->noise_floor < MIN_NOISE_FLOOR)
+        gate->noise_floor = MIN_NOISE_FLOOR;
+}
+
+static void push_lookback(chirp_sdk_gate_t *gate, const short *buffer, size_t length)
+{
+    if (gate->lookback_length == 0)
+        return;
+
+    if (length > gate->lookback_length)
+    {
+        buffer += length - gate->lookback_length;
+        length = gate->lookback_length;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        size_t index = gate->lookback_position + gate->lookback_count;
+        if (index >= gate->lookback_length)
+            index -= gate->lookback_length;
+        gate->lookback[index] = buffer[i];
+
+        if (gate->lookback_count < gate->lookback_length)
+        {
+            gate->lookback_count++;
+        }
+        else if (++gate->lookback_position == gate->lookback_length)
+        {
+            gate->lookback_position = 0;
+        }
+    }
+}
+
+/*
+ * Give the audio held in the lookback buffer to the SDK, oldest first, and
+ * empty it.
+ */
+static chirp_sdk_error_code_t flush_lookback(chirp_sdk_gate_t *gate)
+{
+    size_t first = gate->lookback_length - gate->lookback_position;
+    if (first > gate->lookback_count)
+        first = gate->lookback_count;
+
+    chirp_sdk_error_code_t err = CHIRP_SDK_OK;
+    if (first)
+        err = chirp_sdk_process_shorts_input(gate->sdk, gate->lookback + gate->lookback_position, first);
+    if (err == CHIRP_SDK_OK && gate->lookback_count > first)
+        err = chirp_sdk_process_shorts_input(gate->sdk, gate->lookback, gate->lookback_count - first);
+
+    gate->decoded_samples += gate->lookback_count;
+    gate->skipped_samples -= gate->lookback_count;
+    gate->lookback_position = 0;
+    gate->lookback_count = 0;
+
+    return err;
+}
+
+chirp_sdk_error_code_t chirp_sdk_gate_init(chirp_sdk_gate_t *gate, chirp_sdk_t *sdk, short *lookback, size_t lookback_length,
+                                           float min_frequency, float max_frequency)
+{
+    if (!gate)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!lookback && lookback_length)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    uint32_t sample_rate = chirp_sdk_get_input_sample_rate(sdk);
+    if (sample_rate == 0)
+        return CHIRP_SDK_INVALID_SAMPLE_RATE;
+
+    memset(gate, 0, sizeof(*gate));
+    gate->sdk = sdk;
+    gate->lookback = lookback;
+    gate->lookback_length = lookback_length;
+    gate->state = CHIRP_SDK_GATE_CLOSED;
+
+    init_biquad(&gate->high_pass, FILTER_HIGH_PASS, min_frequency, sample_rate);
+    init_biquad(&gate->low_pass, FILTER_LOW_PASS, max_frequency, sample_rate);
+
+    return chirp_sdk_gate_set_threshold(gate, CHIRP_SDK_GATE_DEFAULT_THRESHOLD, CHIRP_SDK_GATE_DEFAULT_HOLD_TIME);
+}
+
+chirp_sdk_error_code_t chirp_sdk_gate_set_threshold(chirp_sdk_gate_t *gate, float threshold, float hold_time)
+{
+    if (!gate)
+        return CHIRP_SDK_NULL_POINTER;
+
+    gate->threshold = threshold;
+    gate->hold_samples = (uint32_t) (hold_time * chirp_sdk_get_input_sample_rate(gate->sdk));
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_gate_process_shorts_input(chirp_sdk_gate_t *gate, const short *buffer, size_t length)
+{
+    if (!gate)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    float energy = band_energy(gate, buffer, length);
+    bool active = energy > gate->noise_floor * gate->threshold;
+
+    if (gate->state == CHIRP_SDK_GATE_CLOSED)
+    {
+        if (gate->noise_floor == 0 || !active)
+        {
+            update_noise_floor(gate, energy, NOISE_FLOOR_RATE);
+            push_lookback(gate, buffer, length);
+            gate->skipped_samples += length;
+            return CHIRP_SDK_OK;
+        }
+
+        gate->state = CHIRP_SDK_GATE_OPEN;
+        gate->hold_remaining = gate->hold_samples;
+
+        chirp_sdk_error_code_t err = flush_lookback(gate);
+        if (err != CHIRP_SDK_OK)
+            return err;
+    }
+
+    chirp_sdk_error_code_t err = chirp_sdk_process_shorts_input(gate->sdk, buffer, length);
+    gate->decoded_samples += length;
+
+    bool receiving = chirp_sdk_get_state(gate->sdk) == CHIRP_SDK_STATE_RECEIVING;
+    if (!receiving)
+        update_noise_floor(gate, energy, NOISE_FLOOR_OPEN_RATE);
+
+    if (active || receiving)
+    {
+        gate->hold_remaining = gate->hold_samples;
+    }
+    else if (gate->hold_remaining > length)
+    {
+        gate->hold_remaining -= length;
+    }
+    else
+    {
+        gate->hold_remaining = 0;
+        gate->state = CHIRP_SDK_GATE_CLOSED;
+    }
+
+    return err;
+}
+
+chirp_sdk_gate_state_t chirp_sdk_gate_get_state(chirp_sdk_gate_t *gate)
+{
+    if (!gate)
+        return CHIRP_SDK_GATE_CLOSED;
+
+    return gate->state;
+}
@@ -0,0 +1,137 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_gate.h
+ *
+ *  @brief Low-cost band energy gate skipping the decoding of silence.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_GATE_H
+#define CHIRP_SDK_GATE_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Default ratio between the band energy and the noise floor above which the
+ * gate opens, 4 being 6dB.
+ */
+#ifndef CHIRP_SDK_GATE_DEFAULT_THRESHOLD
+#define CHIRP_SDK_GATE_DEFAULT_THRESHOLD 4.0f
+#endif
+
+/**
+ * Default time, in seconds, the gate stays open once the band energy has
+ * fallen back under the threshold and the SDK has stopped receiving.
+ */
+#ifndef CHIRP_SDK_GATE_DEFAULT_HOLD_TIME
+#define CHIRP_SDK_GATE_DEFAULT_HOLD_TIME 0.5f
+#endif
+
+/**
+ * States of the gate.
+ */
+typedef enum {
+    CHIRP_SDK_GATE_CLOSED, ///< The channel is idle, the audio is not decoded.
+    CHIRP_SDK_GATE_OPEN, ///< Energy has been detected in the band, the audio is decoded.
+} chirp_sdk_gate_state_t;
+
+/**
+ * Coefficients and state of a biquad filter section.
+ */
+typedef struct {
+    float b0, b1, b2, a1, a2; ///< Normalised coefficients.
+    float z1, z2; ///< Transposed direct form II state.
+} chirp_sdk_biquad_t;
+
+/**
+ * Structure of the gate. It is owned by the application and must be
+ * initialised with `chirp_sdk_gate_init`.
+ */
+typedef struct {
+    chirp_sdk_t *sdk; ///< The SDK the audio is decoded with.
+    chirp_sdk_biquad_t high_pass; ///< Filter removing the audio under the band.
+    chirp_sdk_biquad_t low_pass; ///< Filter removing the audio over the band.
+    float threshold; ///< Ratio to the noise floor above which the gate opens.
+    float noise_floor; ///< Running estimate of the band energy when not receiving.
+    uint32_t hold_samples; ///< Number of samples the gate is held open for.
+    uint32_t hold_remaining; ///< Number of samples left before the gate closes.
+    short *lookback; ///< Ring buffer of the most recent audio skipped.
+    size_t lookback_length; ///< The length, in samples, of the ring buffer.
+    size_t lookback_position; ///< Index of the oldest sample in the ring buffer.
+    size_t lookback_count; ///< Number of samples stored in the ring buffer.
+    chirp_sdk_gate_state_t state; ///< The current state of the gate.
+    uint64_t decoded_samples; ///< Number of samples given to the SDK.
+    uint64_t skipped_samples; ///< Number of samples skipped while idle.
+} chirp_sdk_gate_t;
+
+/**
+ * Initialise a gate. The input sample rate of the SDK must have been set.
+ *
+ * @param gate            A pointer to the gate to initialise.
+ * @param sdk             A pointer to the SDK structure.
+ * @param lookback        A buffer holding the audio skipped just before the
+ *                        gate opens, which is decoded first so that the start
+ *                        of a chirp is not lost.
+ * @param lookback_length The length, in samples, of the lookback buffer. It
+ *                        should hold at least twice the length of the audio
+ *                        buffers processed.
+ * @param min_frequency   The lowest frequency, in Hz, used by the config.
+ * @param max_frequency   The highest frequency, in Hz, used by the config.
+ * @return                An error code resulting from the call. CHIRP_SDK_OK
+ *                        will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_gate_init(chirp_sdk_gate_t *gate, chirp_sdk_t *sdk, short *lookback, size_t lookback_length,
+                                                      float min_frequency, float max_frequency);
+
+/**
+ * Set the threshold and hold time of the gate.
+ *
+ * @param gate      A pointer to the gate.
+ * @param threshold The ratio between the band energy and the noise floor above
+ *                  which the gate opens. Lower values open more often.
+ * @param hold_time The time, in seconds, the gate stays open once the energy
+ *                  has fallen and the SDK has stopped receiving.
+ * @return          An error code resulting from the call. CHIRP_SDK_OK will
+ *                  be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_gate_set_threshold(chirp_sdk_gate_t *gate, float threshold, float hold_time);
+
+/**
+ * Short audio processing function for the decoding (input), through the
+ * gate. This replaces `chirp_sdk_process_shorts_input`. The buffer is only
+ * given to the SDK when the gate is open.
+ *
+ * @param gate   A pointer to the gate.
+ * @param buffer The input buffer containing mono samples.
+ * @param length The length, in mono samples, of the input buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_gate_process_shorts_input(chirp_sdk_gate_t *gate, const short *buffer, size_t length);
+
+/**
+ * Get the state of the gate. While the gate is closed, the application can
+ * lower the CPU clock or sleep until the next audio buffer.
+ *
+ * @param gate A pointer to the gate.
+ * @return     The state of the gate.
+ */
+PUBLIC_SYM chirp_sdk_gate_state_t chirp_sdk_gate_get_state(chirp_sdk_gate_t *gate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_GATE_H */
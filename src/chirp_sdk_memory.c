@@ -0,0 +1,64 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_memory.c
+ *
+ *  @brief Memory footprint queries of the SDK.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include "chirp_sdk_memory.h"
+
+static chirp_sdk_error_code_t configure(chirp_sdk_t *sdk, const char *config,
+                                        uint32_t input_sample_rate, uint32_t output_sample_rate)
+{
+    chirp_sdk_error_code_t err = chirp_sdk_set_config(sdk, config);
+    if (err != CHIRP_SDK_OK)
+        return err;
+
+    if (input_sample_rate)
+    {
+        err = chirp_sdk_set_input_sample_rate(sdk, input_sample_rate);
+        if (err != CHIRP_SDK_OK)
+            return err;
+    }
+
+    if (output_sample_rate)
+    {
+        err = chirp_sdk_set_output_sample_rate(sdk, output_sample_rate);
+        if (err != CHIRP_SDK_OK)
+            return err;
+    }
+
+    return chirp_sdk_start(sdk);
+}
+
+chirp_sdk_error_code_t chirp_sdk_get_heap_requirement(const char *key, const char *secret, const char *config,
+                                                      uint32_t input_sample_rate, uint32_t output_sample_rate,
+                                                      int32_t *heap_usage)
+{
+    if (!heap_usage)
+        return CHIRP_SDK_NULL_POINTER;
+
+    chirp_sdk_t *sdk = new_chirp_sdk(key, secret);
+    if (!sdk)
+        return CHIRP_SDK_NOT_INITIALISED;
+
+    chirp_sdk_error_code_t err = configure(sdk, config, input_sample_rate, output_sample_rate);
+    if (err == CHIRP_SDK_OK)
+    {
+        *heap_usage = chirp_sdk_get_heap_usage(sdk);
+        err = chirp_sdk_stop(sdk);
+    }
+
+    chirp_sdk_error_code_t del_err = del_chirp_sdk(&sdk);
+
+    return err != CHIRP_SDK_OK ? err : del_err;
+}
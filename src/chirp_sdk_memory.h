@@ -0,0 +1,65 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_memory.h
+ *
+ *  @brief Memory footprint queries of the SDK.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_MEMORY_H
+#define CHIRP_SDK_MEMORY_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Get the heap memory, in bytes, used by an SDK once created, configured and
+ * started with the given config and sample rates, before any audio is
+ * processed.
+ *
+ * This does not include the allocations the decoder makes while a payload is
+ * received, for its error correction and the payload given to `on_received`,
+ * which are freed once the payload has been reported. Leave a margin above
+ * this figure for them: the `Benchmark` example reports the largest heap
+ * usage seen while the longest payload of a config is sent and decoded in
+ * loopback, and allocations made and freed within a single call to the
+ * process functions need some headroom on top of it.
+ *
+ * A temporary SDK is created, started and deleted on the heap of the target
+ * to measure it. Deleting it can leave the heap fragmented if anything else
+ * was allocated in the meantime, or in between its blocks, so this should be
+ * called before any other allocation of the application, at the start of
+ * `setup()` and before components such as Wi-Fi start allocating. Otherwise,
+ * call it once during development and keep the value as a constant.
+ *
+ * @param key                The application key coming from your Chirp Account.
+ * @param secret             The application secret coming from your Chirp Account.
+ * @param config             The config string which will be used.
+ * @param input_sample_rate  The input sample rate which will be used, or 0 to
+ *                           keep the default one.
+ * @param output_sample_rate The output sample rate which will be used, or 0 to
+ *                           keep the default one.
+ * @param heap_usage         A pointer updated with the heap usage in bytes.
+ * @return                   An error code resulting from the call. CHIRP_SDK_OK
+ *                           will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_get_heap_requirement(const char *key, const char *secret, const char *config,
+                                                                 uint32_t input_sample_rate, uint32_t output_sample_rate,
+                                                                 int32_t *heap_usage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_MEMORY_H */
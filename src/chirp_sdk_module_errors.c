@@ -0,0 +1,28 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_module_errors.c
+ *
+ *  @brief Error codes of the modules built on the public API of the SDK.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include "chirp_sdk_module_errors.h"
+
+const char *chirp_sdk_module_error_code_to_string(chirp_sdk_error_code_t err)
+{
+    switch ((int) err)
+    {
+        case CHIRP_SDK_BUFFER_TOO_SHORT:
+            return "The buffer is shorter than the length required.";
+        default:
+            return chirp_sdk_error_code_to_string(err);
+    }
+}
@@ -0,0 +1,52 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_module_errors.h
+ *
+ *  @brief Error codes of the modules built on the public API of the SDK.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_MODULE_ERRORS_H
+#define CHIRP_SDK_MODULE_ERRORS_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * First error code of the modules. They are returned as a
+ * `chirp_sdk_error_code_t`, and start at 240 to stay clear of the codes of
+ * the core while remaining in the range of values its enumeration can hold.
+ */
+#define CHIRP_SDK_MODULE_ERROR_BASE 240
+
+/**
+ * The buffer is shorter than the length required.
+ */
+#define CHIRP_SDK_BUFFER_TOO_SHORT ((chirp_sdk_error_code_t) (CHIRP_SDK_MODULE_ERROR_BASE + 0))
+
+/**
+ * Convert an error code returned by the SDK or by one of its modules to a
+ * string describing the error. The codes of the core are described by
+ * `chirp_sdk_error_code_to_string`.
+ *
+ * @param err The error code which needs to be detailed.
+ * @return    The string describing the error code.
+ */
+PUBLIC_SYM const char *chirp_sdk_module_error_code_to_string(chirp_sdk_error_code_t err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_MODULE_ERRORS_H */
@@ -0,0 +1,331 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_monitor.c
+ *
+ *  @brief Real-time monitoring of the audio processed by the SDK, detecting
+ *         input overruns and output underruns.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include "chirp_sdk_monitor.h"
+
+#ifdef ARDUINO
+extern unsigned long micros(void);
+#endif
+
+static int64_t nominal_samples(uint64_t elapsed, uint32_t sample_rate)
+{
+    return (int64_t) (elapsed * sample_rate / 1000000);
+}
+
+/*
+ * Combine the ratio estimated before the reference with the one measured
+ * over `elapsed` microseconds and `samples` samples since, weighted by the
+ * time of audio each is measured over. Windows shorter than `min_time`
+ * seconds are left out.
+ */
+static float estimate_ratio(chirp_sdk_monitor_stream_t *stream, uint32_t sample_rate, uint64_t elapsed, uint64_t samples,
+                            float min_time, float *time)
+{
+    float window_time = elapsed / 1e6f;
+    int64_t nominal = nominal_samples(elapsed, sample_rate);
+
+    *time = stream->ratio_time;
+    if (!stream->started || window_time < min_time || window_time <= 0 || nominal <= 0)
+        return stream->ratio;
+
+    float window_ratio = (float) samples / (float) nominal;
+    float ratio = (stream->ratio * stream->ratio_time + window_ratio * window_time) / (stream->ratio_time + window_time);
+    if (ratio < 0.5f)
+        ratio = 0.5f;
+    if (ratio > 1.5f)
+        ratio = 1.5f;
+
+    *time = stream->ratio_time + window_time;
+    if (*time > CHIRP_SDK_MONITOR_MAX_RATIO_TIME)
+        *time = CHIRP_SDK_MONITOR_MAX_RATIO_TIME;
+
+    return ratio;
+}
+
+/*
+ * Carry the estimate over, from a window of `elapsed` microseconds and
+ * `samples` samples since the reference, before a new reference is taken.
+ * The window is folded in whatever its length, as the estimates of
+ * consecutive windows weighted by their length add up to the estimate over
+ * their total length.
+ */
+static void fold_ratio(chirp_sdk_monitor_stream_t *stream, uint32_t sample_rate, uint64_t elapsed, uint64_t samples)
+{
+    stream->ratio = estimate_ratio(stream, sample_rate, elapsed, samples, 0, &stream->ratio_time);
+}
+
+/*
+ * Whether the samples counted over a window of `elapsed` microseconds can be
+ * explained by the clocks drifting from the estimated ratio, allowing for
+ * half the tolerance of jitter.
+ */
+static bool is_drift(chirp_sdk_monitor_t *monitor, chirp_sdk_monitor_stream_t *stream, uint32_t sample_rate,
+                     uint64_t elapsed, uint64_t samples)
+{
+    int64_t nominal = nominal_samples(elapsed, sample_rate);
+    if (nominal <= 0)
+        return false;
+
+    float max_drift = stream->ratio_time < CHIRP_SDK_MONITOR_RESTORED_RATIO_TIME ? CHIRP_SDK_MONITOR_MAX_CLOCK_ERROR
+                                                                                 : CHIRP_SDK_MONITOR_MAX_DRIFT;
+    float drift = fabsf((float) samples / (float) nominal - stream->ratio);
+
+    return drift <= max_drift + monitor->tolerance / 4.0f / (float) nominal;
+}
+
+/*
+ * Update the timing of a stream with a new block, and return the deviation,
+ * in samples, between the samples processed and the clock corrected by the
+ * estimated ratio. A positive value means samples are missing.
+ */
+static int64_t update_stream(chirp_sdk_monitor_stream_t *stream, uint32_t now, uint32_t sample_rate, size_t length)
+{
+    if (!stream->started)
+    {
+        /*
+         * The first block was captured, or queued for playing, before this
+         * call, so the reference is taken at its end.
+         */
+        stream->started = true;
+        stream->last_time = now;
+        stream->elapsed = 0;
+        stream->samples = 0;
+        stream->block_time = 0;
+        stream->block_length = 0;
+        stream->deviation = 0;
+        return 0;
+    }
+
+    stream->block_time = (uint32_t) (now - stream->last_time);
+    stream->block_length = length;
+    stream->elapsed += stream->block_time;
+    stream->last_time = now;
+    stream->samples += length;
+
+    /*
+     * Only the difference to the nominal count is scaled, which keeps the
+     * precision of the float ratio over hours of audio.
+     */
+    int64_t nominal = nominal_samples(stream->elapsed, sample_rate);
+    int64_t expected = nominal + (int64_t) (nominal * (stream->ratio - 1.0f));
+    return expected - (int64_t) stream->samples;
+}
+
+static void report(chirp_sdk_monitor_t *monitor, chirp_sdk_monitor_stream_t *stream, uint32_t sample_rate, int64_t deviation,
+                   chirp_sdk_monitor_event_t missing_event, uint32_t *missing_count,
+                   chirp_sdk_monitor_event_t excess_event, uint32_t *excess_count)
+{
+    chirp_sdk_monitor_event_t event;
+    uint32_t samples;
+    int64_t step = deviation - stream->deviation;
+
+    stream->deviation = deviation;
+    if (deviation <= (int64_t) monitor->tolerance && -deviation <= (int64_t) monitor->tolerance)
+        return;
+
+    /*
+     * A deviation which built up slowly, at a plausible rate, is the sample
+     * rate ratio drifting from its estimate rather than an incident. The
+     * estimate is updated, and the window restarted from this block.
+     */
+    if (step <= (int64_t) monitor->tolerance / 2 && -step <= (int64_t) monitor->tolerance / 2 &&
+        is_drift(monitor, stream, sample_rate, stream->elapsed, stream->samples))
+    {
+        fold_ratio(stream, sample_rate, stream->elapsed, stream->samples);
+        stream->elapsed = 0;
+        stream->samples = 0;
+        stream->deviation = 0;
+        return;
+    }
+
+    /*
+     * Take a new reference so that each incident is only reported once. The
+     * block the incident happened in is left out of the estimate. So is the
+     * whole window if it is too short to outweigh the jitter, or if it also
+     * holds earlier losses.
+     */
+    uint64_t window_elapsed = stream->elapsed - stream->block_time;
+    uint64_t window_samples = stream->samples - stream->block_length;
+    if (window_elapsed >= (uint64_t) (CHIRP_SDK_MONITOR_MIN_RATIO_TIME * 1e6f) &&
+        is_drift(monitor, stream, sample_rate, window_elapsed, window_samples))
+        fold_ratio(stream, sample_rate, window_elapsed, window_samples);
+    stream->started = false;
+
+    if (deviation > 0)
+    {
+        event = missing_event;
+        samples = (uint32_t) deviation;
+        (*missing_count)++;
+    }
+    else
+    {
+        event = excess_event;
+        samples = (uint32_t) -deviation;
+        (*excess_count)++;
+    }
+
+    if (monitor->callback)
+        monitor->callback(monitor->ptr, event, samples);
+}
+
+chirp_sdk_error_code_t chirp_sdk_monitor_init(chirp_sdk_monitor_t *monitor, chirp_sdk_t *sdk, chirp_sdk_clock_t clock, uint32_t tolerance)
+{
+    if (!monitor)
+        return CHIRP_SDK_NULL_POINTER;
+
+#ifdef ARDUINO
+    if (!clock)
+        clock = micros;
+#endif
+    if (!clock)
+        return CHIRP_SDK_NULL_POINTER;
+
+    memset(monitor, 0, sizeof(*monitor));
+    monitor->sdk = sdk;
+    monitor->clock = clock;
+    monitor->tolerance = tolerance;
+    monitor->input.ratio = 1.0f;
+    monitor->output.ratio = 1.0f;
+    monitor->frequency_correction = 1.0f;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_monitor_set_callback(chirp_sdk_monitor_t *monitor, chirp_sdk_monitor_callback_t callback, void *ptr)
+{
+    if (!monitor)
+        return CHIRP_SDK_NULL_POINTER;
+
+    monitor->callback = callback;
+    monitor->ptr = ptr;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_monitor_input(chirp_sdk_monitor_t *monitor, size_t length)
+{
+    if (!monitor)
+        return CHIRP_SDK_NULL_POINTER;
+
+    uint32_t now = (uint32_t) monitor->clock();
+    uint32_t sample_rate = chirp_sdk_get_input_sample_rate(monitor->sdk);
+    int64_t deviation = update_stream(&monitor->input, now, sample_rate, length);
+    monitor->stats.input_samples += length;
+
+    report(monitor, &monitor->input, sample_rate, deviation,
+           CHIRP_SDK_MONITOR_INPUT_OVERRUN, &monitor->stats.input_overruns,
+           CHIRP_SDK_MONITOR_INPUT_DISCONTINUITY, &monitor->stats.input_discontinuities);
+
+    if (monitor->frequency_tracking)
+    {
+        float time;
+        float ratio = estimate_ratio(&monitor->input, sample_rate, monitor->input.elapsed, monitor->input.samples,
+                                     CHIRP_SDK_MONITOR_MIN_RATIO_TIME, &time);
+        if (time > 0 && fabsf(ratio - monitor->frequency_correction) > CHIRP_SDK_MONITOR_TRACKING_STEP)
+        {
+            monitor->frequency_correction = ratio;
+            return chirp_sdk_set_frequency_correction(monitor->sdk, ratio);
+        }
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_monitor_output(chirp_sdk_monitor_t *monitor, size_t length)
+{
+    if (!monitor)
+        return CHIRP_SDK_NULL_POINTER;
+
+    uint32_t now = (uint32_t) monitor->clock();
+    uint32_t sample_rate = chirp_sdk_get_output_sample_rate(monitor->sdk);
+    int64_t deviation = update_stream(&monitor->output, now, sample_rate, length);
+    monitor->stats.output_samples += length;
+
+    report(monitor, &monitor->output, sample_rate, deviation,
+           CHIRP_SDK_MONITOR_OUTPUT_UNDERRUN, &monitor->stats.output_underruns,
+           CHIRP_SDK_MONITOR_OUTPUT_DISCONTINUITY, &monitor->stats.output_discontinuities);
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_monitor_get_stats(chirp_sdk_monitor_t *monitor, chirp_sdk_monitor_stats_t *stats)
+{
+    if (!monitor || !stats)
+        return CHIRP_SDK_NULL_POINTER;
+
+    *stats = monitor->stats;
+
+    return CHIRP_SDK_OK;
+}
+
+float chirp_sdk_monitor_get_input_sample_rate_ratio(chirp_sdk_monitor_t *monitor)
+{
+    if (!monitor)
+        return 1.0f;
+
+    float time;
+    return estimate_ratio(&monitor->input, chirp_sdk_get_input_sample_rate(monitor->sdk), monitor->input.elapsed,
+                          monitor->input.samples, CHIRP_SDK_MONITOR_MIN_RATIO_TIME, &time);
+}
+
+chirp_sdk_error_code_t chirp_sdk_monitor_set_input_sample_rate_ratio(chirp_sdk_monitor_t *monitor, float ratio)
+{
+    if (!monitor)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (ratio < 0.5f)
+        ratio = 0.5f;
+    if (ratio > 1.5f)
+        ratio = 1.5f;
+
+    monitor->input.ratio = ratio;
+    monitor->input.ratio_time = CHIRP_SDK_MONITOR_RESTORED_RATIO_TIME;
+    monitor->input.started = false;
+
+    if (!monitor->frequency_tracking)
+        return CHIRP_SDK_OK;
+
+    monitor->frequency_correction = ratio;
+    return chirp_sdk_set_frequency_correction(monitor->sdk, ratio);
+}
+
+chirp_sdk_error_code_t chirp_sdk_monitor_set_frequency_tracking(chirp_sdk_monitor_t *monitor, bool enabled)
+{
+    if (!monitor)
+        return CHIRP_SDK_NULL_POINTER;
+
+    monitor->frequency_tracking = enabled;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_monitor_reset(chirp_sdk_monitor_t *monitor)
+{
+    if (!monitor)
+        return CHIRP_SDK_NULL_POINTER;
+
+    fold_ratio(&monitor->input, chirp_sdk_get_input_sample_rate(monitor->sdk), monitor->input.elapsed, monitor->input.samples);
+    fold_ratio(&monitor->output, chirp_sdk_get_output_sample_rate(monitor->sdk), monitor->output.elapsed, monitor->output.samples);
+    monitor->input.started = false;
+    monitor->output.started = false;
+    memset(&monitor->stats, 0, sizeof(monitor->stats));
+
+    return CHIRP_SDK_OK;
+}
@@ -0,0 +1,273 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_monitor.h
+ *
+ *  @brief Real-time monitoring of the audio processed by the SDK, detecting
+ *         input overruns and output underruns.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_MONITOR_H
+#define CHIRP_SDK_MONITOR_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Time, in seconds, of audio needed before the ratio between the actual and
+ * nominal sample rates is estimated.
+ */
+#ifndef CHIRP_SDK_MONITOR_MIN_RATIO_TIME
+#define CHIRP_SDK_MONITOR_MIN_RATIO_TIME 5.0f
+#endif
+
+/**
+ * Longest time, in seconds, of audio the estimate of the sample rate ratio
+ * is averaged over, so that it follows slow changes of the clocks.
+ */
+#ifndef CHIRP_SDK_MONITOR_MAX_RATIO_TIME
+#define CHIRP_SDK_MONITOR_MAX_RATIO_TIME 3600.0f
+#endif
+
+/**
+ * Weight, in seconds of audio, given to a ratio restored with
+ * `chirp_sdk_monitor_set_input_sample_rate_ratio`.
+ */
+#ifndef CHIRP_SDK_MONITOR_RESTORED_RATIO_TIME
+#define CHIRP_SDK_MONITOR_RESTORED_RATIO_TIME 60.0f
+#endif
+
+/**
+ * Largest change of the sample rate ratio, from its estimate, which is taken
+ * as the clocks drifting rather than as samples lost or in excess. It covers
+ * the drift of a crystal with the temperature and age.
+ */
+#ifndef CHIRP_SDK_MONITOR_MAX_DRIFT
+#define CHIRP_SDK_MONITOR_MAX_DRIFT 0.0005f
+#endif
+
+/**
+ * Largest error of the nominal sample rate taken as drift until the ratio
+ * has been estimated over CHIRP_SDK_MONITOR_RESTORED_RATIO_TIME seconds. It
+ * covers audio clocks derived with fractional dividers, such as the 0.8% of
+ * the PDM microphone of the Nano 33 BLE Sense. Larger errors must be restored
+ * with `chirp_sdk_monitor_set_input_sample_rate_ratio`.
+ */
+#ifndef CHIRP_SDK_MONITOR_MAX_CLOCK_ERROR
+#define CHIRP_SDK_MONITOR_MAX_CLOCK_ERROR 0.01f
+#endif
+
+/**
+ * Smallest change of the estimated ratio applied as a new frequency
+ * correction when tracking is enabled.
+ */
+#ifndef CHIRP_SDK_MONITOR_TRACKING_STEP
+#define CHIRP_SDK_MONITOR_TRACKING_STEP 0.0001f
+#endif
+
+/**
+ * Monotonic clock prototype definition, returning a time in microseconds
+ * which may wrap around. Arduino's `micros` can be used directly.
+ */
+typedef unsigned long (*chirp_sdk_clock_t)(void);
+
+/**
+ * Events detected by the monitor.
+ */
+typedef enum {
+    CHIRP_SDK_MONITOR_INPUT_OVERRUN, ///< Fewer input samples were processed than the clock says were recorded, some were lost.
+    CHIRP_SDK_MONITOR_OUTPUT_UNDERRUN, ///< Fewer output samples were processed than the clock says were played, some were missing.
+    CHIRP_SDK_MONITOR_INPUT_DISCONTINUITY, ///< More input samples were processed than the clock allows.
+    CHIRP_SDK_MONITOR_OUTPUT_DISCONTINUITY, ///< More output samples were processed than the clock allows.
+} chirp_sdk_monitor_event_t;
+
+/**
+ * On_monitor_event callback prototype definition. This is called, if set,
+ * from the context calling `chirp_sdk_monitor_input` or
+ * `chirp_sdk_monitor_output` when an event is detected.
+ *
+ * @param ptr     The pointer given to `chirp_sdk_monitor_set_callback`.
+ * @param event   The event detected.
+ * @param samples The number of samples missing, for an overrun or underrun,
+ *                or in excess, for a discontinuity.
+ */
+typedef void (*chirp_sdk_monitor_callback_t)(void *ptr, chirp_sdk_monitor_event_t event, uint32_t samples);
+
+/**
+ * Statistics of the monitor.
+ */
+typedef struct {
+    uint64_t input_samples; ///< Number of input samples processed.
+    uint64_t output_samples; ///< Number of output samples processed.
+    uint32_t input_overruns; ///< Number of input overruns detected.
+    uint32_t output_underruns; ///< Number of output underruns detected.
+    uint32_t input_discontinuities; ///< Number of input discontinuities detected.
+    uint32_t output_discontinuities; ///< Number of output discontinuities detected.
+} chirp_sdk_monitor_stats_t;
+
+/**
+ * Timing of one direction of the audio, input or output. The reference is
+ * taken on the first block processed and again each time the deviation
+ * passes the tolerance. The ratio between the actual and nominal sample
+ * rates is estimated from the samples processed since the reference, and
+ * carried over the references.
+ */
+typedef struct {
+    bool started; ///< Set once the reference has been taken.
+    uint32_t last_time; ///< Clock time, in microseconds, of the last block.
+    uint64_t elapsed; ///< Time, in microseconds, elapsed since the reference.
+    uint64_t samples; ///< Number of samples processed since the reference.
+    uint32_t block_time; ///< Time, in microseconds, between the last two blocks.
+    size_t block_length; ///< Number of samples in the last block.
+    int64_t deviation; ///< Deviation, in samples, measured on the last block.
+    float ratio; ///< Estimated sample rate ratio before the reference.
+    float ratio_time; ///< Time, in seconds, of audio the ratio is estimated from.
+} chirp_sdk_monitor_stream_t;
+
+/**
+ * Structure of the monitor. It is owned by the application and must be
+ * initialised with `chirp_sdk_monitor_init`.
+ */
+typedef struct {
+    chirp_sdk_t *sdk; ///< The SDK whose sample rates are used.
+    chirp_sdk_clock_t clock; ///< The clock the samples are compared to.
+    uint32_t tolerance; ///< Deviation, in samples, allowed before an event is reported.
+    chirp_sdk_monitor_callback_t callback; ///< Called when an event is detected, or NULL.
+    void *ptr; ///< The pointer passed to the callback.
+    chirp_sdk_monitor_stream_t input; ///< Timing of the input.
+    chirp_sdk_monitor_stream_t output; ///< Timing of the output.
+    chirp_sdk_monitor_stats_t stats; ///< Statistics since the last reset.
+    bool frequency_tracking; ///< Set to apply the input ratio as the frequency correction.
+    float frequency_correction; ///< The frequency correction last applied.
+} chirp_sdk_monitor_t;
+
+/**
+ * Initialise a monitor.
+ *
+ * @param monitor   A pointer to the monitor to initialise.
+ * @param sdk       A pointer to the SDK structure.
+ * @param clock     The monotonic clock to compare the samples to, in
+ *                  microseconds. On Arduino, NULL uses `micros`.
+ * @param tolerance The deviation, in samples, between the samples processed
+ *                  and the clock which is allowed before reporting an event.
+ *                  This must cover the jitter of the audio driver, typically
+ *                  twice the size of the DMA buffers. A deviation building
+ *                  up slowly, at a rate within CHIRP_SDK_MONITOR_MAX_DRIFT
+ *                  of the estimated sample rate ratio, only updates the
+ *                  estimate. Anything faster, such as blocks regularly
+ *                  lost, is reported.
+ * @return          An error code resulting from the call. CHIRP_SDK_OK will
+ *                  be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_monitor_init(chirp_sdk_monitor_t *monitor, chirp_sdk_t *sdk, chirp_sdk_clock_t clock, uint32_t tolerance);
+
+/**
+ * Set the callback called when an event is detected.
+ *
+ * @param monitor  A pointer to the monitor.
+ * @param callback The callback, or NULL to only update the statistics.
+ * @param ptr      A pointer to any data you want to pass to the callback.
+ * @return         An error code resulting from the call. CHIRP_SDK_OK will
+ *                 be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_monitor_set_callback(chirp_sdk_monitor_t *monitor, chirp_sdk_monitor_callback_t callback, void *ptr);
+
+/**
+ * Account for a block of input samples. This should be called each time a
+ * buffer is given to one of the `chirp_sdk_process*_input` functions.
+ *
+ * @param monitor A pointer to the monitor.
+ * @param length  The length, in mono samples, of the block processed.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_monitor_input(chirp_sdk_monitor_t *monitor, size_t length);
+
+/**
+ * Account for a block of output samples. This should be called each time a
+ * buffer is filled by one of the `chirp_sdk_process*_output` functions.
+ *
+ * @param monitor A pointer to the monitor.
+ * @param length  The length, in mono samples, of the block processed.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_monitor_output(chirp_sdk_monitor_t *monitor, size_t length);
+
+/**
+ * Get the statistics of the monitor.
+ *
+ * @param monitor A pointer to the monitor.
+ * @param stats   A pointer updated with the statistics.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_monitor_get_stats(chirp_sdk_monitor_t *monitor, chirp_sdk_monitor_stats_t *stats);
+
+/**
+ * Get the estimated ratio between the actual sample rate of the input and the
+ * input sample rate set on the SDK, measured against the clock of the monitor
+ * over up to CHIRP_SDK_MONITOR_MAX_RATIO_TIME seconds of audio. This is the
+ * value expected by `chirp_sdk_set_frequency_correction`, and can be saved
+ * in non-volatile memory to be restored at boot.
+ *
+ * @param monitor A pointer to the monitor.
+ * @return        The estimated ratio, or the ratio restored or 1 until
+ *                CHIRP_SDK_MONITOR_MIN_RATIO_TIME seconds have been processed.
+ */
+PUBLIC_SYM float chirp_sdk_monitor_get_input_sample_rate_ratio(chirp_sdk_monitor_t *monitor);
+
+/**
+ * Restore a ratio previously returned by
+ * `chirp_sdk_monitor_get_input_sample_rate_ratio`. It is used as the starting
+ * point of the estimate, and applied straight away if tracking is enabled.
+ *
+ * @param monitor A pointer to the monitor.
+ * @param ratio   The ratio, between 0.5 and 1.5.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_monitor_set_input_sample_rate_ratio(chirp_sdk_monitor_t *monitor, float ratio);
+
+/**
+ * Enable or disable the tracking of the frequency correction. When enabled,
+ * `chirp_sdk_monitor_input` sets the frequency correction of the SDK to the
+ * estimated input ratio each time it changes by more than
+ * CHIRP_SDK_MONITOR_TRACKING_STEP. This replaces a hardcoded call to
+ * `chirp_sdk_set_frequency_correction` when the audio clock of the board is
+ * not exactly the sample rate set on the SDK.
+ *
+ * @param monitor A pointer to the monitor.
+ * @param enabled true to track the frequency correction.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_monitor_set_frequency_tracking(chirp_sdk_monitor_t *monitor, bool enabled);
+
+/**
+ * Reset the statistics and the timing references of the monitor. This should
+ * be called when the audio is stopped and restarted. The estimated sample
+ * rate ratios are kept.
+ *
+ * @param monitor A pointer to the monitor.
+ * @return        An error code resulting from the call. CHIRP_SDK_OK will
+ *                be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_monitor_reset(chirp_sdk_monitor_t *monitor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_MONITOR_H */
@@ -0,0 +1,231 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_pipeline.c
+ *
+ *  @brief Audio pipeline between the audio driver and the SDK, with rings of
+ *         buffers filled and emptied by DMA.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "chirp_sdk_pipeline.h"
+
+static inline short *buffer_at(chirp_sdk_pipeline_t *pipeline, chirp_sdk_pipeline_ring_t *ring, uint32_t index)
+{
+    return ring->buffers + (index & (ring->buffer_count - 1)) * pipeline->buffer_length;
+}
+
+/*
+ * Number of buffers published and not released yet. The producer's view is
+ * exact for the head and conservative for the tail, and vice versa.
+ */
+static inline uint32_t ring_count(chirp_sdk_pipeline_ring_t *ring)
+{
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+static void init_ring(chirp_sdk_pipeline_ring_t *ring, short *buffers, uint32_t buffer_count)
+{
+    memset(ring, 0, sizeof(*ring));
+    ring->buffers = buffers;
+    ring->buffer_count = buffers ? buffer_count : 0;
+}
+
+chirp_sdk_error_code_t chirp_sdk_pipeline_init(chirp_sdk_pipeline_t *pipeline, chirp_sdk_t *sdk,
+                                               short *input_buffers, short *output_buffers,
+                                               uint32_t buffer_count, size_t buffer_length)
+{
+    if (!pipeline)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!input_buffers && !output_buffers)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    /*
+     * Round the number of buffers down to a power of two.
+     */
+    if (buffer_count > CHIRP_SDK_PIPELINE_MAX_BUFFERS)
+        buffer_count = CHIRP_SDK_PIPELINE_MAX_BUFFERS;
+    while (buffer_count & (buffer_count - 1))
+        buffer_count &= buffer_count - 1;
+    if (buffer_count < 2)
+        buffer_count = 2;
+
+    memset(pipeline, 0, sizeof(*pipeline));
+    pipeline->sdk = sdk;
+    pipeline->buffer_length = buffer_length;
+    init_ring(&pipeline->input, input_buffers, buffer_count);
+    init_ring(&pipeline->output, output_buffers, buffer_count);
+
+    if (output_buffers)
+    {
+        memset(output_buffers, 0, buffer_count * buffer_length * sizeof(short));
+        for (uint32_t i = 0; i < buffer_count; i++)
+            pipeline->output.lengths[i] = buffer_length;
+        __atomic_store_n(&pipeline->output.head, buffer_count, __ATOMIC_RELEASE);
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+short *chirp_sdk_pipeline_get_input_buffer(chirp_sdk_pipeline_t *pipeline)
+{
+    if (!pipeline || !pipeline->input.buffers)
+        return NULL;
+
+    chirp_sdk_pipeline_ring_t *ring = &pipeline->input;
+    if (ring_count(ring) >= ring->buffer_count)
+        return NULL;
+
+    return buffer_at(pipeline, ring, ring->head);
+}
+
+chirp_sdk_error_code_t chirp_sdk_pipeline_commit_input(chirp_sdk_pipeline_t *pipeline, size_t length)
+{
+    if (!pipeline)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!pipeline->input.buffers)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    chirp_sdk_pipeline_ring_t *ring = &pipeline->input;
+    if (ring_count(ring) >= ring->buffer_count)
+    {
+        pipeline->input_overruns++;
+        return CHIRP_SDK_OK;
+    }
+
+    if (length > pipeline->buffer_length)
+        length = pipeline->buffer_length;
+    ring->lengths[ring->head & (ring->buffer_count - 1)] = length;
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_pipeline_push_input(chirp_sdk_pipeline_t *pipeline, const short *buffer, size_t length)
+{
+    if (!pipeline)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    short *input = chirp_sdk_pipeline_get_input_buffer(pipeline);
+    if (!input)
+    {
+        pipeline->input_overruns++;
+        return CHIRP_SDK_OK;
+    }
+
+    if (length > pipeline->buffer_length)
+        length = pipeline->buffer_length;
+    memcpy(input, buffer, length * sizeof(short));
+
+    return chirp_sdk_pipeline_commit_input(pipeline, length);
+}
+
+const short *chirp_sdk_pipeline_get_output_buffer(chirp_sdk_pipeline_t *pipeline)
+{
+    if (!pipeline || !pipeline->output.buffers)
+        return NULL;
+
+    chirp_sdk_pipeline_ring_t *ring = &pipeline->output;
+    if (ring_count(ring) == 0)
+    {
+        pipeline->output_underruns++;
+        return NULL;
+    }
+
+    return buffer_at(pipeline, ring, ring->tail);
+}
+
+chirp_sdk_error_code_t chirp_sdk_pipeline_release_output(chirp_sdk_pipeline_t *pipeline)
+{
+    if (!pipeline)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!pipeline->output.buffers)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    chirp_sdk_pipeline_ring_t *ring = &pipeline->output;
+    if (ring_count(ring) == 0)
+        return CHIRP_SDK_OK;
+
+    __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_pipeline_pull_output(chirp_sdk_pipeline_t *pipeline, short *buffer, size_t length)
+{
+    if (!pipeline)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    const short *output = chirp_sdk_pipeline_get_output_buffer(pipeline);
+    if (!output)
+    {
+        memset(buffer, 0, length * sizeof(short));
+        return CHIRP_SDK_OK;
+    }
+
+    size_t copied = length < pipeline->buffer_length ? length : pipeline->buffer_length;
+    memcpy(buffer, output, copied * sizeof(short));
+    memset(buffer + copied, 0, (length - copied) * sizeof(short));
+
+    return chirp_sdk_pipeline_release_output(pipeline);
+}
+
+chirp_sdk_error_code_t chirp_sdk_pipeline_process(chirp_sdk_pipeline_t *pipeline)
+{
+    if (!pipeline)
+        return CHIRP_SDK_NULL_POINTER;
+
+    chirp_sdk_pipeline_ring_t *input = &pipeline->input;
+    if (input->buffers)
+    {
+        uint32_t head = __atomic_load_n(&input->head, __ATOMIC_ACQUIRE);
+        while (input->tail != head)
+        {
+            size_t length = input->lengths[input->tail & (input->buffer_count - 1)];
+            chirp_sdk_error_code_t err = chirp_sdk_process_shorts_input(pipeline->sdk, buffer_at(pipeline, input, input->tail), length);
+            __atomic_store_n(&input->tail, input->tail + 1, __ATOMIC_RELEASE);
+            if (err != CHIRP_SDK_OK)
+                return err;
+        }
+    }
+
+    chirp_sdk_pipeline_ring_t *output = &pipeline->output;
+    if (output->buffers)
+    {
+        uint32_t tail = __atomic_load_n(&output->tail, __ATOMIC_ACQUIRE);
+        while (output->head - tail < output->buffer_count)
+        {
+            chirp_sdk_error_code_t err = chirp_sdk_process_shorts_output(pipeline->sdk, buffer_at(pipeline, output, output->head),
+                                                                         pipeline->buffer_length);
+            if (err != CHIRP_SDK_OK)
+                return err;
+            __atomic_store_n(&output->head, output->head + 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_pipeline_get_stats(chirp_sdk_pipeline_t *pipeline, chirp_sdk_pipeline_stats_t *stats)
+{
+    if (!pipeline || !stats)
+        return CHIRP_SDK_NULL_POINTER;
+
+    stats->input_overruns = pipeline->input_overruns;
+    stats->output_underruns = pipeline->output_underruns;
+
+    return CHIRP_SDK_OK;
+}
@@ -0,0 +1,195 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_pipeline.h
+ *
+ *  @brief Audio pipeline between the audio driver and the SDK, with rings of
+ *         buffers filled and emptied by DMA.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_PIPELINE_H
+#define CHIRP_SDK_PIPELINE_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Highest number of buffers in each ring. The number of buffers used must be
+ * a power of two.
+ */
+#ifndef CHIRP_SDK_PIPELINE_MAX_BUFFERS
+#define CHIRP_SDK_PIPELINE_MAX_BUFFERS 8
+#endif
+
+#if (CHIRP_SDK_PIPELINE_MAX_BUFFERS & (CHIRP_SDK_PIPELINE_MAX_BUFFERS - 1)) != 0
+#error "CHIRP_SDK_PIPELINE_MAX_BUFFERS must be a power of two"
+#endif
+
+/**
+ * Single-producer single-consumer ring of audio buffers. The buffers are
+ * handed over whole, so that a DMA transfer can fill or empty one in place.
+ */
+typedef struct {
+    short *buffers; ///< The storage of the buffers, one after the other, or NULL if unused.
+    uint32_t buffer_count; ///< Number of buffers in the ring, a power of two.
+    volatile uint32_t head; ///< Index of the next buffer published, only updated by the producer.
+    volatile uint32_t tail; ///< Index of the next buffer released, only updated by the consumer.
+    size_t lengths[CHIRP_SDK_PIPELINE_MAX_BUFFERS]; ///< The length, in samples, of the audio in each buffer.
+} chirp_sdk_pipeline_ring_t;
+
+/**
+ * Statistics of the pipeline.
+ */
+typedef struct {
+    uint32_t input_overruns; ///< Number of input buffers dropped because the ring was full.
+    uint32_t output_underruns; ///< Number of times the driver found no output buffer ready.
+} chirp_sdk_pipeline_stats_t;
+
+/**
+ * Structure of the pipeline. The audio driver pushes the recorded buffers
+ * into the input ring and pulls the buffers to play from the output ring,
+ * typically from its DMA interrupts. The application calls
+ * `chirp_sdk_pipeline_process` from its main loop or audio task, which
+ * decodes the input buffers and renders the output buffers. It is owned by
+ * the application and must be initialised with `chirp_sdk_pipeline_init`.
+ */
+typedef struct {
+    chirp_sdk_t *sdk; ///< The SDK the audio is processed with.
+    size_t buffer_length; ///< The length, in samples, of each buffer.
+    chirp_sdk_pipeline_ring_t input; ///< Recorded buffers, produced by the driver.
+    chirp_sdk_pipeline_ring_t output; ///< Buffers to play, produced by the application.
+    volatile uint32_t input_overruns; ///< Only updated by the driver.
+    volatile uint32_t output_underruns; ///< Only updated by the driver.
+} chirp_sdk_pipeline_t;
+
+/**
+ * Initialise a pipeline. The output ring is filled with silence straight
+ * away, so that the driver can start playing.
+ *
+ * @param pipeline       A pointer to the pipeline to initialise.
+ * @param sdk            A pointer to the SDK structure.
+ * @param input_buffers  Storage of `buffer_count * buffer_length` samples
+ *                       for the input ring, or NULL to only send.
+ * @param output_buffers Storage of `buffer_count * buffer_length` samples
+ *                       for the output ring, or NULL to only receive.
+ * @param buffer_count   The number of buffers in each ring, a power of two
+ *                       between 2 and CHIRP_SDK_PIPELINE_MAX_BUFFERS. More
+ *                       buffers absorb longer delays of the application, at
+ *                       the cost of a longer output latency.
+ * @param buffer_length  The length, in mono samples, of each buffer.
+ * @return               An error code resulting from the call. CHIRP_SDK_OK
+ *                       will be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_pipeline_init(chirp_sdk_pipeline_t *pipeline, chirp_sdk_t *sdk,
+                                                          short *input_buffers, short *output_buffers,
+                                                          uint32_t buffer_count, size_t buffer_length);
+
+/**
+ * Get the next input buffer for the driver to fill, for example as the
+ * destination of the next DMA transfer. It must be published with
+ * `chirp_sdk_pipeline_commit_input` once filled. To be called by the driver.
+ *
+ * @param pipeline A pointer to the pipeline.
+ * @return         The buffer of `buffer_length` samples, or NULL if the ring
+ *                 is full, in which case the recorded audio must be dropped.
+ */
+PUBLIC_SYM short *chirp_sdk_pipeline_get_input_buffer(chirp_sdk_pipeline_t *pipeline);
+
+/**
+ * Publish the input buffer returned by `chirp_sdk_pipeline_get_input_buffer`.
+ * To be called by the driver.
+ *
+ * @param pipeline A pointer to the pipeline.
+ * @param length   The number of samples written in the buffer, at most
+ *                 `buffer_length`.
+ * @return         An error code resulting from the call. CHIRP_SDK_OK will
+ *                 be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_pipeline_commit_input(chirp_sdk_pipeline_t *pipeline, size_t length);
+
+/**
+ * Copy recorded samples into the next input buffer and publish it. If the
+ * ring is full, the samples are dropped and an overrun is counted. To be
+ * called by the driver.
+ *
+ * @param pipeline A pointer to the pipeline.
+ * @param buffer   The recorded mono samples.
+ * @param length   The length, in samples, of the buffer, at most
+ *                 `buffer_length`.
+ * @return         An error code resulting from the call. CHIRP_SDK_OK will
+ *                 be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_pipeline_push_input(chirp_sdk_pipeline_t *pipeline, const short *buffer, size_t length);
+
+/**
+ * Get the next output buffer for the driver to play. It must be handed back
+ * with `chirp_sdk_pipeline_release_output` once played. To be called by the
+ * driver.
+ *
+ * @param pipeline A pointer to the pipeline.
+ * @return         The buffer of `buffer_length` samples, or NULL if none is
+ *                 ready, in which case an underrun is counted and the driver
+ *                 should play silence.
+ */
+PUBLIC_SYM const short *chirp_sdk_pipeline_get_output_buffer(chirp_sdk_pipeline_t *pipeline);
+
+/**
+ * Hand back the output buffer returned by
+ * `chirp_sdk_pipeline_get_output_buffer`. To be called by the driver.
+ *
+ * @param pipeline A pointer to the pipeline.
+ * @return         An error code resulting from the call. CHIRP_SDK_OK will
+ *                 be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_pipeline_release_output(chirp_sdk_pipeline_t *pipeline);
+
+/**
+ * Copy the next output buffer into the driver's buffer and hand it back, or
+ * fill it with silence if none is ready. To be called by the driver.
+ *
+ * @param pipeline A pointer to the pipeline.
+ * @param buffer   The buffer filled with mono samples.
+ * @param length   The length, in samples, of the buffer. It should be
+ *                 `buffer_length`, the samples past it are silent.
+ * @return         An error code resulting from the call. CHIRP_SDK_OK will
+ *                 be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_pipeline_pull_output(chirp_sdk_pipeline_t *pipeline, short *buffer, size_t length);
+
+/**
+ * Decode the input buffers published by the driver, and render the output
+ * buffers it has handed back. To be called by the application, as often as
+ * one buffer duration.
+ *
+ * @param pipeline A pointer to the pipeline.
+ * @return         An error code resulting from the call. CHIRP_SDK_OK will
+ *                 be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_pipeline_process(chirp_sdk_pipeline_t *pipeline);
+
+/**
+ * Get the statistics of the pipeline.
+ *
+ * @param pipeline A pointer to the pipeline.
+ * @param stats    A pointer updated with the statistics.
+ * @return         An error code resulting from the call. CHIRP_SDK_OK will
+ *                 be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_pipeline_get_stats(chirp_sdk_pipeline_t *pipeline, chirp_sdk_pipeline_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_PIPELINE_H */
@@ -0,0 +1,119 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_pipeline_esp32.h
+ *
+ *  @brief ESP32 I2S driver for `chirp_sdk_pipeline_t`.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_PIPELINE_ESP32_H
+#define CHIRP_SDK_PIPELINE_ESP32_H
+
+#if !defined(ARDUINO_ARCH_ESP32)
+#error "chirp_sdk_pipeline_esp32.h is only available on ESP32"
+#endif
+
+#include <driver/i2s.h>
+
+#include "chirp_sdk_audio.h"
+#include "chirp_sdk_pipeline.h"
+
+/**
+ * Moves the audio between the I2S DMA buffers and the pipeline. The I2S
+ * driver already keeps its own ring of DMA buffers, so `transfer` is meant
+ * to be the only work of a small high priority task, leaving the decoding
+ * and rendering to `chirp_sdk_pipeline_process` in a lower priority one.
+ *
+ * The input is read as left-justified 32-bit words, which are reduced to
+ * the 16-bit samples of the pipeline by a `chirp_sdk_i32_input_t`, to
+ * remove the DC offset of the microphone and apply its gain. The output is
+ * written as 16-bit words.
+ */
+class ChirpPipelineI2S
+{
+public:
+    /**
+     * @param pipeline    A pointer to the initialised pipeline.
+     * @param inputPort   The I2S port recording, or I2S_NUM_MAX if unused.
+     * @param outputPort  The I2S port playing, or I2S_NUM_MAX if unused.
+     * @param inputBuffer Storage of `buffer_length` 32-bit words, to read
+     *                    the input port, or NULL if unused.
+     * @param input       The initialised conversion of the words read, set
+     *                    up for the bit depth of the microphone, or NULL if
+     *                    unused.
+     */
+    ChirpPipelineI2S(chirp_sdk_pipeline_t *pipeline, i2s_port_t inputPort, i2s_port_t outputPort,
+                     int32_t *inputBuffer, chirp_sdk_i32_input_t *input) :
+        pipeline(pipeline), inputPort(inputPort), outputPort(outputPort), inputBuffer(inputBuffer), input(input)
+    {
+    }
+
+    /**
+     * Record one buffer and play one buffer. Blocks until the I2S driver has
+     * room for them, which paces the calling task at the sample rate.
+     *
+     * @param timeout The longest time, in ticks, to wait for each direction.
+     */
+    void transfer(TickType_t timeout = portMAX_DELAY)
+    {
+        size_t length = pipeline->buffer_length;
+        size_t bytes = 0;
+
+        if (inputPort != I2S_NUM_MAX && inputBuffer && input)
+        {
+            i2s_read(inputPort, inputBuffer, length * sizeof(int32_t), &bytes, timeout);
+
+            size_t count = bytes / sizeof(int32_t);
+            short *samples = chirp_sdk_pipeline_get_input_buffer(pipeline);
+            if (!samples)
+            {
+                pipeline->input_overruns++;
+            }
+            else if (count)
+            {
+                chirp_sdk_i32_input_convert(input, inputBuffer, samples, count);
+                chirp_sdk_pipeline_commit_input(pipeline, count);
+            }
+        }
+
+        if (outputPort != I2S_NUM_MAX)
+        {
+            /*
+             * On an underrun a buffer of silence is written instead, so that
+             * the task is still paced by the driver.
+             */
+            const short *output = chirp_sdk_pipeline_get_output_buffer(pipeline);
+            if (output)
+            {
+                i2s_write(outputPort, output, length * sizeof(short), &bytes, timeout);
+                chirp_sdk_pipeline_release_output(pipeline);
+            }
+            else
+            {
+                static const short silence[CHIRP_SDK_AUDIO_CHUNK_SIZE] = {0};
+                for (size_t offset = 0; offset < length; offset += CHIRP_SDK_AUDIO_CHUNK_SIZE)
+                {
+                    size_t count = length - offset < CHIRP_SDK_AUDIO_CHUNK_SIZE ? length - offset : CHIRP_SDK_AUDIO_CHUNK_SIZE;
+                    i2s_write(outputPort, silence, count * sizeof(short), &bytes, timeout);
+                }
+            }
+        }
+    }
+
+private:
+    chirp_sdk_pipeline_t *pipeline;
+    i2s_port_t inputPort;
+    i2s_port_t outputPort;
+    int32_t *inputBuffer;
+    chirp_sdk_i32_input_t *input;
+};
+
+#endif /* !CHIRP_SDK_PIPELINE_ESP32_H */
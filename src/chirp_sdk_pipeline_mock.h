@@ -0,0 +1,105 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_pipeline_mock.h
+ *
+ *  @brief Simulated audio driver for `chirp_sdk_pipeline_t`, to run and
+ *         stress the pipeline on a host without audio hardware.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_PIPELINE_MOCK_H
+#define CHIRP_SDK_PIPELINE_MOCK_H
+
+#include <string.h>
+
+#include "chirp_sdk_pipeline.h"
+
+/**
+ * Simulated audio driver. Each call to `tick` stands for the completion of
+ * one DMA transfer in each direction: one buffer is played from the output
+ * ring, and one buffer is recorded into the input ring. It can be called
+ * from a thread standing for the audio interrupt, while the application
+ * calls `chirp_sdk_pipeline_process` from another one.
+ */
+class ChirpPipelineMock
+{
+public:
+    /**
+     * @param pipeline A pointer to the initialised pipeline.
+     * @param buffer   Storage of `buffer_length` samples for the audio
+     *                 played, which is also recorded when looping back.
+     * @param loopback Whether the audio played is recorded, otherwise
+     *                 silence is recorded.
+     */
+    ChirpPipelineMock(chirp_sdk_pipeline_t *pipeline, short *buffer, bool loopback) :
+        pipeline(pipeline), buffer(buffer), loopback(loopback), ticks(0)
+    {
+    }
+
+    /**
+     * Complete one transfer in each direction.
+     *
+     * @return The buffer played during this tick, valid until the next one.
+     */
+    const short *tick(void)
+    {
+        size_t length = pipeline->buffer_length;
+
+        if (pipeline->output.buffers)
+            chirp_sdk_pipeline_pull_output(pipeline, buffer, length);
+        else
+            memset(buffer, 0, length * sizeof(short));
+
+        if (pipeline->input.buffers)
+        {
+            if (loopback)
+            {
+                chirp_sdk_pipeline_push_input(pipeline, buffer, length);
+            }
+            else
+            {
+                /*
+                 * Silence is recorded straight into the ring, so that the
+                 * buffer played is returned as it is.
+                 */
+                short *input = chirp_sdk_pipeline_get_input_buffer(pipeline);
+                if (input)
+                {
+                    memset(input, 0, length * sizeof(short));
+                    chirp_sdk_pipeline_commit_input(pipeline, length);
+                }
+                else
+                {
+                    pipeline->input_overruns++;
+                }
+            }
+        }
+
+        ticks++;
+        return buffer;
+    }
+
+    /**
+     * @return The number of ticks so far.
+     */
+    uint32_t getTicks(void) const
+    {
+        return ticks;
+    }
+
+private:
+    chirp_sdk_pipeline_t *pipeline;
+    short *buffer;
+    bool loopback;
+    uint32_t ticks;
+};
+
+#endif /* !CHIRP_SDK_PIPELINE_MOCK_H */
@@ -0,0 +1,107 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_pipeline_mxchip.h
+ *
+ *  @brief MXChip IoT DevKit AudioClass driver for `chirp_sdk_pipeline_t`.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_PIPELINE_MXCHIP_H
+#define CHIRP_SDK_PIPELINE_MXCHIP_H
+
+#if !defined(ARDUINO_ARCH_STM32F4)
+#error "chirp_sdk_pipeline_mxchip.h is only available on the MXChip IoT DevKit"
+#endif
+
+#include <string.h>
+
+#include "AudioClassV2.h"
+
+#include "chirp_sdk_pipeline.h"
+
+/**
+ * Number of mono samples in each chunk of the AudioClass, which is the
+ * buffer length the pipeline must be initialised with.
+ */
+#define CHIRP_SDK_PIPELINE_MXCHIP_BUFFER_LENGTH (AUDIO_CHUNK_SIZE / 4)
+
+/**
+ * Moves the audio between the AudioClass and a pipeline. The AudioClass
+ * records and plays 16-bit stereo chunks: the left channel of the recorded
+ * chunks is pushed into the input ring, and the buffers of the output ring
+ * are played on both channels. Both callbacks run from the audio interrupt,
+ * and may run concurrently in full duplex, so each direction has its own
+ * chunk. The application calls `chirp_sdk_pipeline_process` from its main
+ * loop.
+ */
+class ChirpPipelineAudioClass
+{
+public:
+    /**
+     * @param pipeline A pointer to the pipeline, initialised with buffers of
+     *                 CHIRP_SDK_PIPELINE_MXCHIP_BUFFER_LENGTH samples.
+     * @param audio    The AudioClass instance.
+     */
+    ChirpPipelineAudioClass(chirp_sdk_pipeline_t *pipeline, AudioClass &audio) :
+        pipeline(pipeline), audio(audio)
+    {
+    }
+
+    /**
+     * To be called from the callback given to `AudioClass::startRecord`.
+     */
+    void recordCallback(void)
+    {
+        audio.readFromRecordBuffer((char *) recordChunk, AUDIO_CHUNK_SIZE);
+
+        short *input = chirp_sdk_pipeline_get_input_buffer(pipeline);
+        if (!input)
+        {
+            pipeline->input_overruns++;
+            return;
+        }
+
+        for (size_t i = 0; i < CHIRP_SDK_PIPELINE_MXCHIP_BUFFER_LENGTH; i++)
+            input[i] = recordChunk[2 * i];
+        chirp_sdk_pipeline_commit_input(pipeline, CHIRP_SDK_PIPELINE_MXCHIP_BUFFER_LENGTH);
+    }
+
+    /**
+     * To be called from the callback given to `AudioClass::startPlay`.
+     */
+    void playCallback(void)
+    {
+        const short *output = chirp_sdk_pipeline_get_output_buffer(pipeline);
+        if (output)
+        {
+            for (size_t i = 0; i < CHIRP_SDK_PIPELINE_MXCHIP_BUFFER_LENGTH; i++)
+            {
+                playChunk[2 * i] = output[i];
+                playChunk[2 * i + 1] = output[i];
+            }
+            chirp_sdk_pipeline_release_output(pipeline);
+        }
+        else
+        {
+            memset(playChunk, 0, sizeof(playChunk));
+        }
+
+        audio.writeToPlayBuffer((char *) playChunk, AUDIO_CHUNK_SIZE);
+    }
+
+private:
+    chirp_sdk_pipeline_t *pipeline;
+    AudioClass &audio;
+    short recordChunk[AUDIO_CHUNK_SIZE / 2];
+    short playChunk[AUDIO_CHUNK_SIZE / 2];
+};
+
+#endif /* !CHIRP_SDK_PIPELINE_MXCHIP_H */
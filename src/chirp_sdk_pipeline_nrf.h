@@ -0,0 +1,86 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_pipeline_nrf.h
+ *
+ *  @brief nRF52840 PDM input driver for `chirp_sdk_pipeline_t`.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_PIPELINE_NRF_H
+#define CHIRP_SDK_PIPELINE_NRF_H
+
+#if !defined(ARDUINO_ARCH_NRF52840)
+#error "chirp_sdk_pipeline_nrf.h is only available on nRF52840"
+#endif
+
+#include <PDM.h>
+
+#include "chirp_sdk_pipeline.h"
+
+/**
+ * Records the PDM microphone into the input ring of a pipeline. The samples
+ * are read from the PDM library straight into the next buffer of the ring,
+ * from the PDM interrupt. The application calls `chirp_sdk_pipeline_process`
+ * from its main loop, so the decoding does not lengthen the interrupt.
+ *
+ * The buffer length of the pipeline should be at least the PDM buffer size,
+ * 256 samples by default, otherwise the extra samples are dropped.
+ */
+class ChirpPipelinePDM
+{
+public:
+    /**
+     * @param pipeline A pointer to the initialised pipeline.
+     */
+    ChirpPipelinePDM(chirp_sdk_pipeline_t *pipeline) :
+        pipeline(pipeline)
+    {
+    }
+
+    /**
+     * To be called from the callback set with `PDM.onReceive`.
+     */
+    void onReceive(void)
+    {
+        size_t capacity = pipeline->buffer_length * sizeof(short);
+        int bytes = PDM.available();
+        if (bytes > (int) capacity)
+            bytes = capacity;
+
+        short *input = chirp_sdk_pipeline_get_input_buffer(pipeline);
+        if (!input)
+        {
+            /*
+             * The samples must still be read, for the PDM library to
+             * release its buffer.
+             */
+            short discard[64];
+            while (bytes > 0)
+            {
+                int read = PDM.read(discard, bytes < (int) sizeof(discard) ? bytes : sizeof(discard));
+                if (read <= 0)
+                    break;
+                bytes -= read;
+            }
+            pipeline->input_overruns++;
+            return;
+        }
+
+        bytes = PDM.read(input, bytes);
+        if (bytes > 0)
+            chirp_sdk_pipeline_commit_input(pipeline, bytes / sizeof(short));
+    }
+
+private:
+    chirp_sdk_pipeline_t *pipeline;
+};
+
+#endif /* !CHIRP_SDK_PIPELINE_NRF_H */
@@ -0,0 +1,122 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_pipeline_samd.h
+ *
+ *  @brief SAMD21 I2S output driver for `chirp_sdk_pipeline_t`, using the
+ *         Adafruit_ZeroDMA library.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_PIPELINE_SAMD_H
+#define CHIRP_SDK_PIPELINE_SAMD_H
+
+#if !defined(ARDUINO_ARCH_SAMD)
+#error "chirp_sdk_pipeline_samd.h is only available on SAMD"
+#endif
+
+#include <string.h>
+
+#include <Adafruit_ZeroDMA.h>
+
+#include "chirp_sdk_pipeline.h"
+
+/**
+ * Plays the output ring of a pipeline through I2S, as 32-bit stereo frames.
+ * The DMA alternates between two stereo buffers: when one transfer completes,
+ * the next one is started on the other buffer, and the buffer just played is
+ * refilled from the pipeline, all from the DMA interrupt. The application
+ * only calls `chirp_sdk_pipeline_process` from its main loop.
+ */
+class ChirpPipelineZeroDMA
+{
+public:
+    /**
+     * @param pipeline A pointer to the initialised pipeline.
+     * @param buffers  Storage of `4 * buffer_length` 32-bit words, for the
+     *                 two stereo DMA buffers.
+     */
+    ChirpPipelineZeroDMA(chirp_sdk_pipeline_t *pipeline, int32_t *buffers) :
+        pipeline(pipeline), buffers(buffers), current(0), dma(NULL), descriptor(NULL)
+    {
+    }
+
+    /**
+     * Set up the transfers, and fill both buffers. The DMA channel must have
+     * been allocated, with the I2S transmit trigger.
+     *
+     * @param dma The DMA channel.
+     * @return    The DMA descriptor, to start the job with.
+     */
+    DmacDescriptor *begin(Adafruit_ZeroDMA *dma)
+    {
+        this->dma = dma;
+        fill(0);
+        fill(1);
+
+        descriptor = dma->addDescriptor(buffers, (void *) (&I2S->DATA[0].reg),
+                                        2 * pipeline->buffer_length, DMA_BEAT_SIZE_WORD, true, false);
+        return descriptor;
+    }
+
+    /**
+     * To be called from the transfer complete callback of the DMA channel.
+     *
+     * @return The status of the next transfer.
+     */
+    ZeroDMAstatus transferComplete(void)
+    {
+        uint8_t played = current;
+        current ^= 1;
+        dma->changeDescriptor(descriptor, buffer(current));
+        ZeroDMAstatus stat = dma->startJob();
+        fill(played);
+        return stat;
+    }
+
+private:
+    int32_t *buffer(uint8_t index)
+    {
+        return buffers + index * 2 * pipeline->buffer_length;
+    }
+
+    /*
+     * Expand the next mono buffer to left justified stereo frames, or to
+     * silence on an underrun.
+     */
+    void fill(uint8_t index)
+    {
+        int32_t *frames = buffer(index);
+        size_t length = pipeline->buffer_length;
+        const short *output = chirp_sdk_pipeline_get_output_buffer(pipeline);
+
+        if (!output)
+        {
+            memset(frames, 0, 2 * length * sizeof(int32_t));
+            return;
+        }
+
+        for (size_t i = 0; i < length; i++)
+        {
+            int32_t value = (int32_t) output[i] * 65536;
+            frames[2 * i] = value;
+            frames[2 * i + 1] = value;
+        }
+        chirp_sdk_pipeline_release_output(pipeline);
+    }
+
+    chirp_sdk_pipeline_t *pipeline;
+    int32_t *buffers;
+    volatile uint8_t current;
+    Adafruit_ZeroDMA *dma;
+    DmacDescriptor *descriptor;
+};
+
+#endif /* !CHIRP_SDK_PIPELINE_SAMD_H */
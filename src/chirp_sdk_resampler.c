@@ -0,0 +1,234 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_resampler.c
+ *
+ *  @brief Polyphase resampling between the audio hardware sample rate and
+ *         a lower processing sample rate of the SDK.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <string.h>
+
+#include "chirp_sdk_resampler.h"
+#include "chirp_sdk_audio.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/*
+ * Stopband attenuation of the low-pass filter, in dB, which sets the shape
+ * parameter of the Kaiser window.
+ */
+#define STOPBAND_ATTENUATION 60.0f
+
+static inline short saturate_short(int32_t value)
+{
+    if (value > 32767)
+        return 32767;
+    if (value < -32768)
+        return -32768;
+    return (short) value;
+}
+
+/*
+ * Zeroth order modified Bessel function of the first kind, from its power
+ * series.
+ */
+static float bessel_i0(float x)
+{
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0f * k)) * (x / (2.0f * k));
+        sum += term;
+        if (term < sum * 1e-9f)
+            break;
+    }
+    return sum;
+}
+
+/*
+ * Design a Kaiser windowed-sinc low-pass filter of factor * taps per phase
+ * coefficients, scaled to a unity DC gain per output sample. The cutoff is
+ * the Nyquist frequency of the processing sample rate, so the transition
+ * band is centred on it: the images and aliases of the audio below the
+ * transition band fall in the stopband. The output filter is stored with
+ * its phases contiguous, multiplied by the factor to make up for the zeros
+ * stuffed between the processing samples.
+ */
+static void design_filter(chirp_sdk_resampler_t *resampler)
+{
+    uint16_t length = resampler->factor * CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE;
+    float cutoff = 1.0f / (2.0f * resampler->factor);
+    float centre = (length - 1) / 2.0f;
+    float beta = 0.1102f * (STOPBAND_ATTENUATION - 8.7f);
+    float window[CHIRP_SDK_RESAMPLER_MAX_TAPS];
+    float sum = 0;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        float t = i - centre;
+        float sinc = t == 0 ? 2.0f * cutoff : sinf(2.0f * (float) M_PI * cutoff * t) / ((float) M_PI * t);
+        float r = t / centre;
+        float w = bessel_i0(beta * sqrtf(1.0f - r * r)) / bessel_i0(beta);
+        window[i] = sinc * w;
+        sum += window[i];
+    }
+
+    float scale = 32767.0f / sum;
+    if (resampler->direction == CHIRP_SDK_RESAMPLER_OUTPUT)
+        scale *= resampler->factor;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        uint16_t index = i;
+        if (resampler->direction == CHIRP_SDK_RESAMPLER_OUTPUT)
+            index = (i % resampler->factor) * CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE + i / resampler->factor;
+        resampler->coefficients[index] = saturate_short(lrintf(window[i] * scale));
+    }
+}
+
+/*
+ * Push a sample in the doubled history so that the taps are always read
+ * contiguously from the newest sample.
+ */
+static inline void push_history(chirp_sdk_resampler_t *resampler, short sample)
+{
+    resampler->position = (resampler->position ? resampler->position : resampler->taps) - 1;
+    resampler->history[resampler->position] = sample;
+    resampler->history[resampler->position + resampler->taps] = sample;
+}
+
+static inline short run_filter(const int16_t *coefficients, const short *history, uint16_t taps)
+{
+    int32_t acc = 1 << 14;
+    for (uint16_t i = 0; i < taps; i++)
+        acc += (int32_t) coefficients[i] * history[i];
+    return saturate_short(acc >> 15);
+}
+
+chirp_sdk_error_code_t chirp_sdk_resampler_init(chirp_sdk_resampler_t *resampler, chirp_sdk_t *sdk,
+                                                chirp_sdk_resampler_direction_t direction, uint8_t factor)
+{
+    if (!resampler)
+        return CHIRP_SDK_NULL_POINTER;
+
+    if (factor < 1)
+        factor = 1;
+    if (factor > CHIRP_SDK_RESAMPLER_MAX_FACTOR)
+        factor = CHIRP_SDK_RESAMPLER_MAX_FACTOR;
+
+    memset(resampler, 0, sizeof(*resampler));
+    resampler->sdk = sdk;
+    resampler->direction = direction;
+    resampler->factor = factor;
+
+    if (factor == 1)
+        return CHIRP_SDK_OK;
+
+    design_filter(resampler);
+    if (direction == CHIRP_SDK_RESAMPLER_INPUT)
+        resampler->taps = factor * CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE;
+    else
+        resampler->taps = CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_resampler_process_shorts_input(chirp_sdk_resampler_t *resampler, const short *buffer, size_t length)
+{
+    if (!resampler)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    if (resampler->factor == 1)
+        return chirp_sdk_process_shorts_input(resampler->sdk, buffer, length);
+
+    /*
+     * Only every factor-th output of the filter is computed, so the cost is
+     * the number of taps per phase for each hardware sample.
+     */
+    short chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+    size_t count = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        push_history(resampler, buffer[i]);
+        if (++resampler->phase < resampler->factor)
+            continue;
+        resampler->phase = 0;
+
+        chunk[count++] = run_filter(resampler->coefficients, resampler->history + resampler->position, resampler->taps);
+        if (count == CHIRP_SDK_AUDIO_CHUNK_SIZE)
+        {
+            chirp_sdk_error_code_t err = chirp_sdk_process_shorts_input(resampler->sdk, chunk, count);
+            if (err != CHIRP_SDK_OK)
+                return err;
+            count = 0;
+        }
+    }
+
+    if (count)
+        return chirp_sdk_process_shorts_input(resampler->sdk, chunk, count);
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_resampler_process_shorts_output(chirp_sdk_resampler_t *resampler, short *buffer, size_t length)
+{
+    if (!resampler)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    if (resampler->factor == 1)
+        return chirp_sdk_process_shorts_output(resampler->sdk, buffer, length);
+
+    short chunk[CHIRP_SDK_AUDIO_CHUNK_SIZE];
+    size_t count = 0;
+    size_t index = 0;
+
+    while (length)
+    {
+        if (resampler->phase == 0)
+        {
+            if (index == count)
+            {
+                /*
+                 * Render exactly the processing samples needed by this
+                 * buffer so that none are held over to the next call.
+                 */
+                count = (length + resampler->factor - 1) / resampler->factor;
+                if (count > CHIRP_SDK_AUDIO_CHUNK_SIZE)
+                    count = CHIRP_SDK_AUDIO_CHUNK_SIZE;
+                index = 0;
+
+                chirp_sdk_error_code_t err = chirp_sdk_process_shorts_output(resampler->sdk, chunk, count);
+                if (err != CHIRP_SDK_OK)
+                    return err;
+            }
+            push_history(resampler, chunk[index++]);
+        }
+
+        const int16_t *coefficients = resampler->coefficients + resampler->phase * CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE;
+        *buffer++ = run_filter(coefficients, resampler->history + resampler->position, resampler->taps);
+        length--;
+
+        if (++resampler->phase == resampler->factor)
+            resampler->phase = 0;
+    }
+
+    return CHIRP_SDK_OK;
+}
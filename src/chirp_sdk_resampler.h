@@ -0,0 +1,124 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_resampler.h
+ *
+ *  @brief Polyphase resampling between the audio hardware sample rate and
+ *         a lower processing sample rate of the SDK.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_RESAMPLER_H
+#define CHIRP_SDK_RESAMPLER_H
+
+#include "chirp_sdk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Highest ratio supported between the hardware and processing sample rates.
+ */
+#ifndef CHIRP_SDK_RESAMPLER_MAX_FACTOR
+#define CHIRP_SDK_RESAMPLER_MAX_FACTOR 6
+#endif
+
+/**
+ * Number of filter taps per polyphase branch. The cost of the resampler is
+ * this many multiply-adds per hardware sample.
+ *
+ * The low-pass filter is a Kaiser windowed-sinc, cut off at the Nyquist
+ * frequency of the processing sample rate. With 24 taps per phase, it is
+ * flat within 0.01dB up to 80% of that frequency, and attenuates by 60dB or
+ * more from 120% of it, as measured by `extras/test/test_resampler.c`: 62dB
+ * when interpolating by 2, and 59.9dB in the worst case, decimating by 6.
+ * So the images and aliases of the audio in the passband are attenuated by
+ * about 60dB. Fewer taps widen the transition band.
+ */
+#ifndef CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE
+#define CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE 24
+#endif
+
+#define CHIRP_SDK_RESAMPLER_MAX_TAPS (CHIRP_SDK_RESAMPLER_MAX_FACTOR * CHIRP_SDK_RESAMPLER_TAPS_PER_PHASE)
+
+/**
+ * Direction of the audio through the resampler.
+ */
+typedef enum {
+    CHIRP_SDK_RESAMPLER_INPUT, ///< Decimate the recorded audio before decoding it.
+    CHIRP_SDK_RESAMPLER_OUTPUT, ///< Interpolate the encoded audio before playing it.
+} chirp_sdk_resampler_direction_t;
+
+/**
+ * Structure of a resampler. It is owned by the application and must be
+ * initialised with `chirp_sdk_resampler_init`. One resampler is needed per
+ * direction.
+ */
+typedef struct {
+    chirp_sdk_t *sdk; ///< The SDK the audio is processed with.
+    chirp_sdk_resampler_direction_t direction; ///< The direction of the audio.
+    uint8_t factor; ///< Ratio between the hardware and processing sample rates.
+    uint8_t phase; ///< Position, in hardware samples, within the current processing sample.
+    uint16_t taps; ///< Number of taps of the history used.
+    uint16_t position; ///< Index of the newest sample in the history.
+    int16_t coefficients[CHIRP_SDK_RESAMPLER_MAX_TAPS]; ///< Q15 low-pass filter, in polyphase order for the output.
+    short history[2 * CHIRP_SDK_RESAMPLER_MAX_TAPS]; ///< Doubled history of the filter input.
+} chirp_sdk_resampler_t;
+
+/**
+ * Initialise a resampler. The matching sample rate of the SDK must be set to
+ * the hardware sample rate divided by the factor, for example with
+ * `chirp_sdk_set_input_sample_rate(sdk, 48000 / 3)` to decode the audio of a
+ * 48kHz microphone at 16kHz. The processing sample rate should not be lower
+ * than the one the config is designed for.
+ *
+ * @param resampler A pointer to the resampler to initialise.
+ * @param sdk       A pointer to the SDK structure.
+ * @param direction Whether the resampler is used for the input or the output.
+ * @param factor    The ratio between the hardware and processing sample rates,
+ *                  between 1 and CHIRP_SDK_RESAMPLER_MAX_FACTOR.
+ * @return          An error code resulting from the call. CHIRP_SDK_OK will
+ *                  be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_resampler_init(chirp_sdk_resampler_t *resampler, chirp_sdk_t *sdk,
+                                                           chirp_sdk_resampler_direction_t direction, uint8_t factor);
+
+/**
+ * Short audio processing function for the decoding (input) of audio recorded
+ * at the hardware sample rate. This replaces `chirp_sdk_process_shorts_input`.
+ *
+ * @param resampler A pointer to an input resampler.
+ * @param buffer    The input buffer containing mono samples at the hardware
+ *                  sample rate.
+ * @param length    The length, in mono samples, of the input buffer.
+ * @return          An error code resulting from the call. CHIRP_SDK_OK will
+ *                  be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_resampler_process_shorts_input(chirp_sdk_resampler_t *resampler, const short *buffer, size_t length);
+
+/**
+ * Short audio processing function for the encoding (output) of audio played
+ * at the hardware sample rate. This replaces `chirp_sdk_process_shorts_output`.
+ *
+ * @param resampler A pointer to an output resampler.
+ * @param buffer    The output buffer which will be filled with new mono
+ *                  samples at the hardware sample rate.
+ * @param length    The length, in mono samples, of the output buffer.
+ * @return          An error code resulting from the call. CHIRP_SDK_OK will
+ *                  be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_resampler_process_shorts_output(chirp_sdk_resampler_t *resampler, short *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_RESAMPLER_H */
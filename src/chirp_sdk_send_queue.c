@@ -0,0 +1,192 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_send_queue.c
+ *
+ *  @brief Queue of payloads sent back to back by the SDK.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "chirp_sdk_send_queue.h"
+
+typedef chirp_sdk_error_code_t (*process_output_t)(chirp_sdk_t *sdk, void *format, void *buffer, size_t offset, size_t length);
+
+static chirp_sdk_error_code_t process_floats(chirp_sdk_t *sdk, void *format, void *buffer, size_t offset, size_t length)
+{
+    (void) format;
+    return chirp_sdk_process_output(sdk, (float *) buffer + offset, length);
+}
+
+static chirp_sdk_error_code_t process_shorts(chirp_sdk_t *sdk, void *format, void *buffer, size_t offset, size_t length)
+{
+    (void) format;
+    return chirp_sdk_process_shorts_output(sdk, (short *) buffer + offset, length);
+}
+
+static chirp_sdk_error_code_t process_i32(chirp_sdk_t *sdk, void *format, void *buffer, size_t offset, size_t length)
+{
+    chirp_sdk_dac_output_t *output = (chirp_sdk_dac_output_t *) format;
+    return chirp_sdk_process_i32_output(sdk, output, (int32_t *) buffer + offset * output->channel_count, length);
+}
+
+/*
+ * Index of the next payload to send, skipping the ones discarded by a flush.
+ */
+static uint32_t next_index(chirp_sdk_send_queue_t *queue)
+{
+    uint32_t tail = queue->tail;
+    uint32_t flush_head = __atomic_load_n(&queue->flush_head, __ATOMIC_ACQUIRE);
+    return (int32_t) (flush_head - tail) > 0 ? flush_head : tail;
+}
+
+static bool is_pending(chirp_sdk_send_queue_t *queue)
+{
+    return next_index(queue) != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Release the payloads discarded by a flush, so that the producer can reuse
+ * their storage, and return the index of the next payload to send. Only the
+ * consumer moves the tail, as the producer cannot tell whether the payload
+ * at the tail is being copied.
+ */
+static uint32_t release_flushed(chirp_sdk_send_queue_t *queue)
+{
+    uint32_t index = next_index(queue);
+    if (index != queue->tail)
+        __atomic_store_n(&queue->tail, index, __ATOMIC_RELEASE);
+    return index;
+}
+
+/*
+ * Start sending the next payload if the SDK is not already sending one.
+ */
+static chirp_sdk_error_code_t send_next(chirp_sdk_send_queue_t *queue)
+{
+    uint32_t index = release_flushed(queue);
+
+    if (index == __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) ||
+        chirp_sdk_get_state(queue->sdk) == CHIRP_SDK_STATE_SENDING)
+        return CHIRP_SDK_OK;
+
+    queue->current = queue->items[index & (CHIRP_SDK_SEND_QUEUE_SIZE - 1)];
+    __atomic_store_n(&queue->tail, index + 1, __ATOMIC_RELEASE);
+
+    return chirp_sdk_send(queue->sdk, queue->current.bytes, queue->current.length);
+}
+
+static chirp_sdk_error_code_t process(chirp_sdk_send_queue_t *queue, void *format, void *buffer, size_t length, process_output_t process_output)
+{
+    if (!queue)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!buffer)
+        return CHIRP_SDK_NULL_BUFFER;
+
+    size_t offset = 0;
+    while (offset < length)
+    {
+        chirp_sdk_error_code_t err = send_next(queue);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        /*
+         * Only slice the buffer while a payload is waiting, to detect the end
+         * of the current one as soon as possible.
+         */
+        size_t count = length - offset;
+        if (is_pending(queue) && count > CHIRP_SDK_SEND_QUEUE_SLICE_SIZE)
+            count = CHIRP_SDK_SEND_QUEUE_SLICE_SIZE;
+
+        err = process_output(queue->sdk, format, buffer, offset, count);
+        if (err != CHIRP_SDK_OK)
+            return err;
+
+        offset += count;
+    }
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_send_queue_init(chirp_sdk_send_queue_t *queue, chirp_sdk_t *sdk)
+{
+    if (!queue || !sdk)
+        return CHIRP_SDK_NULL_POINTER;
+
+    queue->sdk = sdk;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->flush_head = 0;
+    queue->current.length = 0;
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_send_queue_push(chirp_sdk_send_queue_t *queue, const uint8_t *bytes, size_t length)
+{
+    if (!queue)
+        return CHIRP_SDK_NULL_POINTER;
+    if (!bytes)
+        return CHIRP_SDK_NULL_BUFFER;
+    if (length > CHIRP_SDK_SEND_QUEUE_MAX_PAYLOAD_LENGTH)
+        return CHIRP_SDK_PAYLOAD_TOO_LONG;
+
+    chirp_sdk_error_code_t err = chirp_sdk_is_valid(queue->sdk, bytes, length);
+    if (err != CHIRP_SDK_OK)
+        return err;
+
+    uint32_t head = queue->head;
+    if (head - __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE) >= CHIRP_SDK_SEND_QUEUE_SIZE)
+        return CHIRP_SDK_ALREADY_SENDING;
+
+    chirp_sdk_send_queue_item_t *item = &queue->items[head & (CHIRP_SDK_SEND_QUEUE_SIZE - 1)];
+    memcpy(item->bytes, bytes, length);
+    item->length = length;
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+    return CHIRP_SDK_OK;
+}
+
+size_t chirp_sdk_send_queue_get_depth(chirp_sdk_send_queue_t *queue)
+{
+    if (!queue)
+        return 0;
+
+    return __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) - next_index(queue);
+}
+
+chirp_sdk_error_code_t chirp_sdk_send_queue_flush(chirp_sdk_send_queue_t *queue)
+{
+    if (!queue)
+        return CHIRP_SDK_NULL_POINTER;
+
+    __atomic_store_n(&queue->flush_head, queue->head, __ATOMIC_RELEASE);
+
+    return CHIRP_SDK_OK;
+}
+
+chirp_sdk_error_code_t chirp_sdk_send_queue_process_output(chirp_sdk_send_queue_t *queue, float *buffer, size_t length)
+{
+    return process(queue, NULL, buffer, length, process_floats);
+}
+
+chirp_sdk_error_code_t chirp_sdk_send_queue_process_shorts_output(chirp_sdk_send_queue_t *queue, short *buffer, size_t length)
+{
+    return process(queue, NULL, buffer, length, process_shorts);
+}
+
+chirp_sdk_error_code_t chirp_sdk_send_queue_process_i32_output(chirp_sdk_send_queue_t *queue, chirp_sdk_dac_output_t *output, int32_t *buffer, size_t length)
+{
+    if (!output)
+        return CHIRP_SDK_NULL_POINTER;
+
+    return process(queue, output, buffer, length, process_i32);
+}
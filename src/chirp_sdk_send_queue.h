@@ -0,0 +1,170 @@
+/**-----------------------------------------------------------------------------
+ *
+ *  ASIO CONFIDENTIAL
+ *
+ *  @file chirp_sdk_send_queue.h
+ *
+ *  @brief Queue of payloads sent back to back by the SDK.
+ *
+ *  All contents are strictly proprietary, and not for copying, resale,
+ *  or use outside of the agreed license.
+ *
+ *  Copyright © 2011-2019, Asio Ltd.
+ *  All rights reserved.
+ *
+ *----------------------------------------------------------------------------*/
+
+#ifndef CHIRP_SDK_SEND_QUEUE_H
+#define CHIRP_SDK_SEND_QUEUE_H
+
+#include "chirp_sdk.h"
+#include "chirp_sdk_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Number of payloads which can be waiting to be sent. This must be a power
+ * of two.
+ */
+#ifndef CHIRP_SDK_SEND_QUEUE_SIZE
+#define CHIRP_SDK_SEND_QUEUE_SIZE 4
+#endif
+
+#if (CHIRP_SDK_SEND_QUEUE_SIZE & (CHIRP_SDK_SEND_QUEUE_SIZE - 1)) != 0
+#error "CHIRP_SDK_SEND_QUEUE_SIZE must be a power of two"
+#endif
+
+/**
+ * Maximum length, in bytes, of a queued payload.
+ */
+#ifndef CHIRP_SDK_SEND_QUEUE_MAX_PAYLOAD_LENGTH
+#define CHIRP_SDK_SEND_QUEUE_MAX_PAYLOAD_LENGTH 32
+#endif
+
+/**
+ * While a payload is waiting, the output is rendered in slices of this many
+ * samples so that the next payload starts at most this many samples after
+ * the end of the previous one, whatever the size of the audio buffers.
+ */
+#ifndef CHIRP_SDK_SEND_QUEUE_SLICE_SIZE
+#define CHIRP_SDK_SEND_QUEUE_SLICE_SIZE 32
+#endif
+
+/**
+ * A queued payload.
+ */
+typedef struct {
+    size_t length; ///< The length, in bytes, of the payload.
+    uint8_t bytes[CHIRP_SDK_SEND_QUEUE_MAX_PAYLOAD_LENGTH]; ///< A copy of the payload.
+} chirp_sdk_send_queue_item_t;
+
+/**
+ * Single-producer single-consumer queue of payloads. The producer is the
+ * context calling `chirp_sdk_send_queue_push` and `chirp_sdk_send_queue_flush`
+ * and the consumer the context processing the output. The structure is
+ * owned by the application and must be initialised with
+ * `chirp_sdk_send_queue_init`.
+ */
+typedef struct {
+    chirp_sdk_t *sdk; ///< The SDK the payloads are sent with.
+    volatile uint32_t head; ///< Index of the next payload pushed, only updated by the producer.
+    volatile uint32_t tail; ///< Index of the next payload sent, only updated by the consumer.
+    volatile uint32_t flush_head; ///< Payloads before this index are discarded, only updated by the producer.
+    chirp_sdk_send_queue_item_t current; ///< The payload being sent.
+    chirp_sdk_send_queue_item_t items[CHIRP_SDK_SEND_QUEUE_SIZE]; ///< The payloads storage.
+} chirp_sdk_send_queue_t;
+
+/**
+ * Initialise a send queue.
+ *
+ * @param queue A pointer to the queue to initialise.
+ * @param sdk   A pointer to the SDK structure the payloads are sent with.
+ * @return      An error code resulting from the call. CHIRP_SDK_OK will
+ *              be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_send_queue_init(chirp_sdk_send_queue_t *queue, chirp_sdk_t *sdk);
+
+/**
+ * Queue a payload to be sent. The payload is copied, and will be sent as soon
+ * as the previous ones have been sent, without waiting for the `on_sent`
+ * callback. The `on_sending` and `on_sent` callbacks are still called for
+ * each payload.
+ *
+ * @param queue  A pointer to the send queue.
+ * @param bytes  A pointer to the payload that will be sent.
+ * @param length The length, in bytes, of the payload which will be sent.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well, CHIRP_SDK_ALREADY_SENDING
+ *               if the queue is full. The room freed by
+ *               `chirp_sdk_send_queue_flush` is only available once the
+ *               output has been processed again.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_send_queue_push(chirp_sdk_send_queue_t *queue, const uint8_t *bytes, size_t length);
+
+/**
+ * Get the number of payloads waiting to be sent, not counting the one being
+ * sent.
+ *
+ * @param queue A pointer to the send queue.
+ * @return      The number of payloads waiting.
+ */
+PUBLIC_SYM size_t chirp_sdk_send_queue_get_depth(chirp_sdk_send_queue_t *queue);
+
+/**
+ * Discard all the payloads waiting to be sent. The payload being sent, if
+ * any, is not interrupted. Their room in the queue is released by the next
+ * call to one of the `chirp_sdk_send_queue_process*` functions.
+ *
+ * @param queue A pointer to the send queue.
+ * @return      An error code resulting from the call. CHIRP_SDK_OK will
+ *              be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_send_queue_flush(chirp_sdk_send_queue_t *queue);
+
+/**
+ * Float audio processing function for the encoding (output), sending the
+ * queued payloads one after another. This replaces `chirp_sdk_process_output`.
+ *
+ * @param queue  A pointer to the send queue.
+ * @param buffer The output buffer which will be filled with new mono samples.
+ * @param length The length, in mono samples, of the output buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_send_queue_process_output(chirp_sdk_send_queue_t *queue, float *buffer, size_t length);
+
+/**
+ * Short audio processing function for the encoding (output), sending the
+ * queued payloads one after another. This replaces
+ * `chirp_sdk_process_shorts_output`.
+ *
+ * @param queue  A pointer to the send queue.
+ * @param buffer The output buffer which will be filled with new mono samples.
+ * @param length The length, in mono samples, of the output buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_send_queue_process_shorts_output(chirp_sdk_send_queue_t *queue, short *buffer, size_t length);
+
+/**
+ * 32-bit audio processing function for the encoding (output), sending the
+ * queued payloads one after another. This replaces
+ * `chirp_sdk_process_i32_output`.
+ *
+ * @param queue  A pointer to the send queue.
+ * @param output A pointer to the output conversion state.
+ * @param buffer The output buffer which will be filled with
+ *               `length * channel_count` left-justified 32-bit words.
+ * @param length The length, in frames, of the output buffer.
+ * @return       An error code resulting from the call. CHIRP_SDK_OK will
+ *               be returned if everything went well.
+ */
+PUBLIC_SYM chirp_sdk_error_code_t chirp_sdk_send_queue_process_i32_output(chirp_sdk_send_queue_t *queue, chirp_sdk_dac_output_t *output, int32_t *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !CHIRP_SDK_SEND_QUEUE_H */